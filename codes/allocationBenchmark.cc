@@ -0,0 +1,83 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is a benchmark of the pooled allocation mode on the tcp-80211b
+ * scenario and will output the results in a file called allocationBenchmark.dat.
+ * Use the following command to run:
+ * ./waf --run allocationBenchmark
+ *
+ * The nWifi=50 saturated scenario is run alternately with and without
+ * --packetPool. We report the allocations and malloc calls made during the
+ * simulation, the wall time and the simulated seconds per wall-clock second.
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE ("allocationBenchmark");
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  uint32_t runs = 3;
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("nWifi", "Number of STA nodes", engine.nWifi);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", engine.simulationTime);
+  cmd.AddValue ("runs", "Number of runs of each mode", runs);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  // Create the data file.
+  std::string dataFileName = "allocationBenchmark.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "packetPool" << "\t" << "allocations" << "\t" << "mallocCalls"
+           << "\t" << "wallTime" << "\t" << "simSecondsPerWallSecond" << "\t" << "throughput" << std::endl;
+  std::cout << "nWifi" << "\t" << "packetPool" << "\t" << "allocations" << "\t" << "mallocCalls"
+            << "\t" << "wallTime" << "\t" << "simSecondsPerWallSecond" << "\t" << "throughput" << std::endl;
+
+  double wallTime[2] = { 0, 0 };
+  uint64_t mallocCalls[2] = { 0, 0 };
+  for (uint32_t run = 0; run < runs; run++)
+    {
+      for (uint32_t pool = 0; pool < 2; pool++)
+        {
+          ExperimentConfig config = engine;
+          config.packetPool = pool;
+
+          /* Every point starts from the same state, so its manifest replays it. */
+          ResetExperiment (config);
+          ExperimentResult result = RunExperiment (config);
+          double speed = (config.simulationTime + 1) / result.wallTime;
+          wallTime[pool] += result.wallTime;
+          mallocCalls[pool] += result.mallocCalls;
+
+          // Write the data file.
+          dataFile << config.nWifi << "\t" << pool << "\t" << result.allocations << "\t" << result.mallocCalls
+                   << "\t" << result.wallTime << "\t" << speed << "\t" << result.throughput << std::endl;
+          std::cout << config.nWifi << "\t" << pool << "\t" << result.allocations << "\t" << result.mallocCalls
+                    << "\t" << result.wallTime << "\t" << speed << "\t" << result.throughput << std::endl;
+        }
+    }
+  /* Warm pools may take no new chunk at all during the runs. */
+  std::cout << "# packetPool: ";
+  if (mallocCalls[1] > 0)
+    {
+      std::cout << (double) mallocCalls[0] / mallocCalls[1] << "x fewer malloc calls, ";
+    }
+  else
+    {
+      std::cout << "no malloc calls (" << mallocCalls[0] << " without), ";
+    }
+  std::cout << wallTime[0] / wallTime[1] << "x wall-time speedup" << std::endl;
+  // Close the data file.
+  dataFile.close ();
+  return 0;
+}
@@ -0,0 +1,110 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * A list of attribute values for one TypeId whose names are looked up and
+ * whose values are checked once, when they are added. Applying the batch to
+ * an object then calls the attribute accessors directly, with no name
+ * lookup or string parsing per object.
+ *
+ *   AttributeBatch phyAttributes (WifiPhy::GetTypeId ());
+ *   phyAttributes.Add ("TxPowerStart", DoubleValue (10.0));
+ *   ...
+ *   phyAttributes.Apply (phy);
+ */
+
+#ifndef ATTRIBUTE_BATCH_H
+#define ATTRIBUTE_BATCH_H
+
+#include "ns3/core-module.h"
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class AttributeBatch
+{
+public:
+  AttributeBatch (TypeId tid);
+
+  void Add (const std::string &name, const AttributeValue &value);
+  void Apply (Ptr<ObjectBase> object) const;
+  uint32_t GetN (void) const;
+
+  /* Hand the values to a helper that sets them through its ObjectFactory
+   * (YansWifiPhyHelper::Set (), ...). */
+  template <typename Helper>
+  void SetOn (Helper &helper) const;
+
+private:
+  struct Entry
+  {
+    std::string name;
+    Ptr<const AttributeAccessor> accessor;
+    Ptr<const AttributeValue> value;
+  };
+
+  TypeId m_tid;
+  std::vector<Entry> m_entries;
+};
+
+AttributeBatch::AttributeBatch (TypeId tid)
+  : m_tid (tid)
+{
+}
+
+void
+AttributeBatch::Add (const std::string &name, const AttributeValue &value)
+{
+  struct TypeId::AttributeInformation info;
+  if (!m_tid.LookupAttributeByName (name, &info))
+    {
+      NS_FATAL_ERROR ("No attribute " << name << " in " << m_tid.GetName ());
+    }
+  if (!(info.flags & TypeId::ATTR_SET) || !info.accessor->HasSetter ())
+    {
+      NS_FATAL_ERROR ("Attribute " << m_tid.GetName () << "::" << name << " cannot be set");
+    }
+  Ptr<AttributeValue> checked = info.checker->CreateValidValue (value);
+  if (checked == 0)
+    {
+      NS_FATAL_ERROR ("Invalid value for attribute " << m_tid.GetName () << "::" << name);
+    }
+  Entry entry;
+  entry.name = name;
+  entry.accessor = info.accessor;
+  entry.value = checked;
+  m_entries.push_back (entry);
+}
+
+void
+AttributeBatch::Apply (Ptr<ObjectBase> object) const
+{
+  for (std::vector<Entry>::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      if (!i->accessor->Set (PeekPointer (object), *i->value))
+        {
+          NS_FATAL_ERROR ("Could not set " << m_tid.GetName () << "::" << i->name);
+        }
+    }
+}
+
+uint32_t
+AttributeBatch::GetN (void) const
+{
+  return m_entries.size ();
+}
+
+template <typename Helper>
+void
+AttributeBatch::SetOn (Helper &helper) const
+{
+  for (std::vector<Entry>::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      helper.Set (i->name, *i->value);
+    }
+}
+
+} // namespace ns3
+
+#endif /* ATTRIBUTE_BATCH_H */
@@ -0,0 +1,83 @@
+#!/bin/sh
+#
+# Author: Qiaoqiao Li <joyinbritish@me.com>
+#
+# Release build of the tcp-80211b programs. Run it from the top of the ns-3
+# tree, with this directory copied into scratch/:
+#   sh scratch/build-optimized.sh [--pgo] [--no-lto] [--no-benchmark]
+#
+# 1. builds the debug profile into build-debug and runs the regression
+#    benchmark there, kept as regressionBenchmark-debug.dat,
+# 2. builds the optimized profile (-O3 -march=native, NS_LOG and asserts
+#    compiled out) into build-optimized, with link time optimization over
+#    a static ns-3 so that the simulator core inlines into the wifi models,
+# 3. with --pgo, builds it instrumented first, trains it on the nWifi=50
+#    scenario and rebuilds it with the profile,
+# 4. runs the regression benchmark on the optimized build, which reports
+#    its speedup over regressionBenchmark-debug.dat.
+#
+# The tree is left configured for build-optimized, so ./waf --run runs the
+# fast build from then on. The LTO and profile flags are GCC's.
+
+set -e
+
+LTO=1
+PGO=0
+BENCHMARK=1
+for arg in "$@"
+do
+  case "$arg" in
+    --pgo) PGO=1 ;;
+    --no-lto) LTO=0 ;;
+    --no-benchmark) BENCHMARK=0 ;;
+    *) echo "usage: sh scratch/build-optimized.sh [--pgo] [--no-lto] [--no-benchmark]" >&2; exit 2 ;;
+  esac
+done
+
+if [ ! -x ./waf ] || [ ! -f scratch/tcp-80211b.cc ]
+then
+  echo "Run from the top of the ns-3 tree, with the tcp-80211b programs in scratch/" >&2
+  exit 1
+fi
+
+CONFIGURE_OPTIONS="--disable-python --disable-tests --disable-examples"
+PROFILE_DIR="$PWD/build-optimized-profile"
+
+# Configure the optimized profile with extra compiler and linker flags ($1).
+configure_optimized ()
+{
+  flags="$1"
+  if [ $LTO -eq 1 ]
+  then
+    flags="$flags -flto"
+  fi
+  CXXFLAGS_EXTRA="$flags" LINKFLAGS="$flags" AR=gcc-ar \
+    ./waf configure --build-profile=optimized --out=build-optimized --enable-static $CONFIGURE_OPTIONS
+}
+
+# The regression benchmark exits with 1 on a regression against its
+# baseline, which must not stop the build.
+if [ $BENCHMARK -eq 1 ]
+then
+  ./waf configure --build-profile=debug --out=build-debug $CONFIGURE_OPTIONS
+  ./waf build
+  ./waf --run regressionBenchmark || true
+  mv regressionBenchmark.dat regressionBenchmark-debug.dat
+fi
+
+if [ $PGO -eq 1 ]
+then
+  rm -rf "$PROFILE_DIR"
+  configure_optimized "-fprofile-generate=$PROFILE_DIR"
+  ./waf build
+  ./waf --run "tcp-80211b --nWifi=50 --manifestDir="
+  configure_optimized "-fprofile-use=$PROFILE_DIR -fprofile-correction -Wno-missing-profile"
+else
+  configure_optimized ""
+fi
+./waf build
+
+if [ $BENCHMARK -eq 1 ]
+then
+  ./waf --run "regressionBenchmark --reference=regressionBenchmark-debug.dat" || true
+fi
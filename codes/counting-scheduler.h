@@ -0,0 +1,233 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * A scheduler that forwards every operation to one of the ns-3 event set
+ * backends (map, heap, calendar or list) and counts what passes through it,
+ * so that experiments can report executed events and the peak event set size
+ * whatever backend they run on.
+ *
+ * Observers that sample a run (telemetry, throughput series) schedule their
+ * events with ScheduleUncounted (): the counts leave those out, so that a
+ * run reports the same events with and without them.
+ */
+
+#ifndef COUNTING_SCHEDULER_H
+#define COUNTING_SCHEDULER_H
+
+#include "ns3/core-module.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class CountingScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  CountingScheduler ();
+  virtual ~CountingScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+  uint64_t GetExecuted (void) const;
+  uint64_t GetCancelled (void) const;
+  uint64_t GetSize (void) const;
+  uint64_t GetPeakSize (void) const;
+
+  /* The scheduler currently installed in the simulator, or 0 if the
+   * simulator does not run on a CountingScheduler. */
+  static CountingScheduler * GetCurrent (void);
+
+  /* Simulator::Schedule (), for an event that is executed but not counted. */
+  template <typename MEM, typename OBJ>
+  static EventId ScheduleUncounted (const Time &delay, MEM mem, OBJ obj);
+
+protected:
+  virtual void NotifyConstructionCompleted (void);
+
+private:
+  /* Forget uid if it is an uncounted event, and tell whether it was. */
+  bool TakeUncounted (uint32_t uid);
+
+  static CountingScheduler *s_current;
+
+  TypeId m_backendTid;
+  Ptr<Scheduler> m_backend;
+  uint64_t m_executed;
+  uint64_t m_cancelled;
+  uint64_t m_size;
+  uint64_t m_peakSize;
+  bool m_uncounting;                                 /* The events inserted now are not counted. */
+  std::vector<uint32_t> m_uncounted;                 /* Uids of the pending uncounted events, one per observer. */
+};
+
+CountingScheduler *CountingScheduler::s_current = 0;
+
+NS_OBJECT_ENSURE_REGISTERED (CountingScheduler);
+
+TypeId
+CountingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CountingScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<CountingScheduler> ()
+    .AddAttribute ("Backend",
+                   "The event set implementation the operations are forwarded to.",
+                   TypeIdValue (MapScheduler::GetTypeId ()),
+                   MakeTypeIdAccessor (&CountingScheduler::m_backendTid),
+                   MakeTypeIdChecker ())
+  ;
+  return tid;
+}
+
+CountingScheduler::CountingScheduler ()
+  : m_executed (0),
+    m_cancelled (0),
+    m_size (0),
+    m_peakSize (0),
+    m_uncounting (false)
+{
+}
+
+CountingScheduler::~CountingScheduler ()
+{
+  if (s_current == this)
+    {
+      s_current = 0;
+    }
+}
+
+void
+CountingScheduler::NotifyConstructionCompleted (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_backendTid);
+  m_backend = factory.Create<Scheduler> ();
+  s_current = this;
+  Scheduler::NotifyConstructionCompleted ();
+}
+
+void
+CountingScheduler::Insert (const Event &ev)
+{
+  m_backend->Insert (ev);
+  if (m_uncounting)
+    {
+      m_uncounted.push_back (ev.key.m_uid);
+      return;
+    }
+  m_size++;
+  if (m_size > m_peakSize)
+    {
+      m_peakSize = m_size;
+    }
+}
+
+bool
+CountingScheduler::IsEmpty (void) const
+{
+  return m_backend->IsEmpty ();
+}
+
+Scheduler::Event
+CountingScheduler::PeekNext (void) const
+{
+  return m_backend->PeekNext ();
+}
+
+Scheduler::Event
+CountingScheduler::RemoveNext (void)
+{
+  Event ev = m_backend->RemoveNext ();
+  if (!TakeUncounted (ev.key.m_uid))
+    {
+      m_executed++;
+      m_size--;
+    }
+  return ev;
+}
+
+void
+CountingScheduler::Remove (const Event &ev)
+{
+  if (!TakeUncounted (ev.key.m_uid))
+    {
+      m_cancelled++;
+      m_size--;
+    }
+  m_backend->Remove (ev);
+}
+
+bool
+CountingScheduler::TakeUncounted (uint32_t uid)
+{
+  if (m_uncounted.empty ())
+    {
+      return false;
+    }
+  std::vector<uint32_t>::iterator i = std::find (m_uncounted.begin (), m_uncounted.end (), uid);
+  if (i == m_uncounted.end ())
+    {
+      return false;
+    }
+  m_uncounted.erase (i);
+  return true;
+}
+
+uint64_t
+CountingScheduler::GetExecuted (void) const
+{
+  return m_executed;
+}
+
+uint64_t
+CountingScheduler::GetCancelled (void) const
+{
+  return m_cancelled;
+}
+
+uint64_t
+CountingScheduler::GetSize (void) const
+{
+  return m_size;
+}
+
+uint64_t
+CountingScheduler::GetPeakSize (void) const
+{
+  return m_peakSize;
+}
+
+CountingScheduler *
+CountingScheduler::GetCurrent (void)
+{
+  return s_current;
+}
+
+template <typename MEM, typename OBJ>
+EventId
+CountingScheduler::ScheduleUncounted (const Time &delay, MEM mem, OBJ obj)
+{
+  CountingScheduler *scheduler = GetCurrent ();
+  if (scheduler != 0)
+    {
+      scheduler->m_uncounting = true;
+    }
+  EventId id = Simulator::Schedule (delay, mem, obj);
+  if (scheduler != 0)
+    {
+      scheduler->m_uncounting = false;
+    }
+  return id;
+}
+
+} // namespace ns3
+
+#endif /* COUNTING_SCHEDULER_H */
@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * The DSSS and HR/DSSS chunk success rates of YansErrorRateModel, looked up
+ * in a table instead of computed with exp () and pow () on every chunk.
+ *
+ * For each of the 1, 2, 5.5 and 11 Mbps modes the table holds the log of
+ * the bit success rate, ln (1 - BER), on a grid that is linear within each
+ * power of two of the SNR. The grid point below an SNR is the top bits of
+ * its IEEE 754 representation and the interpolation weight is the rest of
+ * its mantissa, so a lookup needs no log10 () and no branch, and
+ *   success rate = exp (nbits * ln (1 - BER)).
+ * The table is filled from DsssErrorRateModel, so it follows the build
+ * (GSL or not). SNRs outside the table and non DSSS modes go to
+ * YansErrorRateModel.
+ *
+ * Only the lookup is cheaper. There is no batched or vectorized path, the
+ * batched API was not delivered: the simulator asks for one chunk at a
+ * time and exp () stays a call per chunk.
+ */
+
+#ifndef DSSS_ERROR_RATE_TABLE_H
+#define DSSS_ERROR_RATE_TABLE_H
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/dsss-error-rate-model.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace ns3 {
+
+class TabulatedDsssErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+  TabulatedDsssErrorRateModel ();
+
+  virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+  /* Index of the table of a DSSS mode, -1 for the others. */
+  static int GetTable (WifiMode mode);
+
+  /* Grid points per power of two of the SNR, as a power of two. */
+  static const uint32_t STEP_BITS = 8;
+  /* SNRs in [2^MIN_EXPONENT, 2^MAX_EXPONENT) (-18 to 30 dB) are tabulated. */
+  static const int MIN_EXPONENT = -6;
+  static const int MAX_EXPONENT = 10;
+  static const uint32_t TABLES = 4;
+
+private:
+  /* ln (1 - BER) of every mode on the grid, filled once per process. */
+  static const std::vector<double> &GetLogSuccess (uint32_t table);
+
+  Ptr<YansErrorRateModel> m_scalar;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedDsssErrorRateModel);
+
+static const uint32_t DSSS_TABLE_SHIFT = 52 - TabulatedDsssErrorRateModel::STEP_BITS;
+static const uint64_t DSSS_TABLE_FRACTION_MASK = (uint64_t (1) << DSSS_TABLE_SHIFT) - 1;
+/* Grid index 0 is 2^MIN_EXPONENT: its biased exponent, mantissa 0. */
+static const uint64_t DSSS_TABLE_BASE = uint64_t (1023 + TabulatedDsssErrorRateModel::MIN_EXPONENT)
+  << TabulatedDsssErrorRateModel::STEP_BITS;
+static const uint64_t DSSS_TABLE_POINTS = (uint64_t (TabulatedDsssErrorRateModel::MAX_EXPONENT
+                                                     - TabulatedDsssErrorRateModel::MIN_EXPONENT)
+                                           << TabulatedDsssErrorRateModel::STEP_BITS) + 1;
+
+TypeId
+TabulatedDsssErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedDsssErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .AddConstructor<TabulatedDsssErrorRateModel> ()
+  ;
+  return tid;
+}
+
+TabulatedDsssErrorRateModel::TabulatedDsssErrorRateModel ()
+  : m_scalar (CreateObject<YansErrorRateModel> ())
+{
+}
+
+int
+TabulatedDsssErrorRateModel::GetTable (WifiMode mode)
+{
+  static const uint32_t uids[TABLES] = {
+    WifiPhy::GetDsssRate1Mbps ().GetUid (),
+    WifiPhy::GetDsssRate2Mbps ().GetUid (),
+    WifiPhy::GetDsssRate5_5Mbps ().GetUid (),
+    WifiPhy::GetDsssRate11Mbps ().GetUid ()
+  };
+  for (uint32_t i = 0; i < TABLES; i++)
+    {
+      if (mode.GetUid () == uids[i])
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+const std::vector<double> &
+TabulatedDsssErrorRateModel::GetLogSuccess (uint32_t table)
+{
+  static std::vector<double> logSuccess[TABLES];
+  if (logSuccess[table].empty ())
+    {
+      logSuccess[table].resize (DSSS_TABLE_POINTS);
+      for (uint64_t i = 0; i < DSSS_TABLE_POINTS; i++)
+        {
+          /* The SNR of the grid point, exactly. */
+          uint64_t bits = (DSSS_TABLE_BASE + i) << DSSS_TABLE_SHIFT;
+          double snr;
+          std::memcpy (&snr, &bits, sizeof (snr));
+          double success = 0;
+          switch (table)
+            {
+            case 0:
+              success = DsssErrorRateModel::GetDsssDbpskSuccessRate (snr, 1);
+              break;
+            case 1:
+              success = DsssErrorRateModel::GetDsssDqpskSuccessRate (snr, 1);
+              break;
+            case 2:
+              success = DsssErrorRateModel::GetDsssDqpskCck5_5SuccessRate (snr, 1);
+              break;
+            default:
+              success = DsssErrorRateModel::GetDsssDqpskCck11SuccessRate (snr, 1);
+              break;
+            }
+          logSuccess[table][i] = std::log (success);
+        }
+    }
+  return logSuccess[table];
+}
+
+double
+TabulatedDsssErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  int table = GetTable (mode);
+  uint64_t bits;
+  std::memcpy (&bits, &snr, sizeof (bits));
+  /* Negative SNRs and NaNs have the sign bit set and land above the table. */
+  int64_t index = int64_t (bits >> DSSS_TABLE_SHIFT) - int64_t (DSSS_TABLE_BASE);
+  if (table < 0 || !(snr > 0) || index < 0 || index >= int64_t (DSSS_TABLE_POINTS - 1))
+    {
+      return m_scalar->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  const double *logSuccess = &GetLogSuccess (table)[0];
+  double fraction = (bits & DSSS_TABLE_FRACTION_MASK) * (1.0 / (DSSS_TABLE_FRACTION_MASK + 1));
+  double lnSuccess = logSuccess[index] + fraction * (logSuccess[index + 1] - logSuccess[index]);
+  return std::exp (nbits * lnSuccess);
+}
+
+} // namespace ns3
+
+#endif /* DSSS_ERROR_RATE_TABLE_H */
@@ -0,0 +1,159 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is a benchmark of the tabulated DSSS error rate model against
+ * YansErrorRateModel and will output the results in a file called errorRateBenchmark.dat.
+ * Use the following command to run:
+ * ./waf --run errorRateBenchmark
+ *
+ * For each of the 1, 2, 5.5 and 11 Mbps modes we report
+ * - the largest difference of the chunk success rate to YansErrorRateModel
+ *   over SNRs from -20 to 35 dB in steps of 0.001 dB; the benchmark fails
+ *   if it exceeds --tolerance or is not a number,
+ * - the time per chunk of YansErrorRateModel and of the table, on random
+ *   SNRs from 0 to 20 dB.
+ * Then the tcp-80211b scenario with nWifi=200 runs with --errorModel=yans
+ * and --errorModel=table and we report both wall times and throughputs.
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("errorRateBenchmark");
+
+using namespace ns3;
+
+/* The larger difference, NaN once either is: std::max () would keep the
+ * old maximum and let a NaN success rate pass the tolerance. */
+static double
+MaxError (double maxError, double error)
+{
+  if (std::isnan (maxError) || std::isnan (error))
+    {
+      return std::numeric_limits<double>::quiet_NaN ();
+    }
+  return std::max (maxError, error);
+}
+
+/* Nanoseconds per chunk spent by evaluate (). */
+template <typename F>
+double
+TimeChunks (F evaluate, uint32_t chunks)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  evaluate ();
+  return std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count () / chunks;
+}
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  engine.nWifi = 200;
+  uint32_t chunks = 1000000;
+  uint32_t chunkBits = 8 * 1090;
+  double tolerance = 1e-4;
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("nWifi", "Number of STA nodes of the scenario runs", engine.nWifi);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", engine.simulationTime);
+  cmd.AddValue ("chunks", "Chunks evaluated per mode and model in the micro-benchmark", chunks);
+  cmd.AddValue ("chunkBits", "Bits per chunk", chunkBits);
+  cmd.AddValue ("tolerance", "Largest accepted difference of the success rates", tolerance);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  Ptr<YansErrorRateModel> yans = CreateObject<YansErrorRateModel> ();
+  Ptr<TabulatedDsssErrorRateModel> table = CreateObject<TabulatedDsssErrorRateModel> ();
+  WifiMode modes[] = { WifiPhy::GetDsssRate1Mbps (), WifiPhy::GetDsssRate2Mbps (),
+                       WifiPhy::GetDsssRate5_5Mbps (), WifiPhy::GetDsssRate11Mbps () };
+
+  Ptr<UniformRandomVariable> snrDb = CreateObject<UniformRandomVariable> ();
+  snrDb->SetStream (1);
+  std::vector<double> snr (chunks);
+  for (uint32_t i = 0; i < chunks; i++)
+    {
+      snr[i] = std::pow (10.0, snrDb->GetValue (0, 20) / 10.0);
+    }
+  std::vector<uint64_t> nbits (chunks, chunkBits);
+
+  // Create the data file.
+  std::string dataFileName = "errorRateBenchmark.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  dataFile << "mode" << "\t" << "maxError" << "\t" << "yansNs" << "\t" << "tableNs" << "\t" << "speedup" << std::endl;
+  std::cout << "mode" << "\t" << "maxError" << "\t" << "yansNs" << "\t" << "tableNs" << "\t" << "speedup" << std::endl;
+
+  bool accurate = true;
+  for (uint32_t m = 0; m < 4; m++)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (modes[m]);
+
+      /* Accuracy over the whole SNR range, table included. */
+      double maxError = 0;
+      for (int32_t milliDb = -20000; milliDb <= 35000; milliDb++)
+        {
+          double linear = std::pow (10.0, milliDb / 10000.0);
+          double error = std::abs (table->GetChunkSuccessRate (modes[m], txVector, linear, chunkBits)
+                                   - yans->GetChunkSuccessRate (modes[m], txVector, linear, chunkBits));
+          maxError = MaxError (maxError, error);
+        }
+
+      std::vector<double> scalar (chunks);
+      std::vector<double> single (chunks);
+      double yansNs = TimeChunks ([&] {
+        for (uint32_t i = 0; i < chunks; i++)
+          {
+            scalar[i] = yans->GetChunkSuccessRate (modes[m], txVector, snr[i], nbits[i]);
+          }
+      }, chunks);
+      double tableNs = TimeChunks ([&] {
+        for (uint32_t i = 0; i < chunks; i++)
+          {
+            single[i] = table->GetChunkSuccessRate (modes[m], txVector, snr[i], nbits[i]);
+          }
+      }, chunks);
+      for (uint32_t i = 0; i < chunks; i++)
+        {
+          maxError = MaxError (maxError, std::abs (single[i] - scalar[i]));
+        }
+      accurate &= !std::isnan (maxError) && maxError <= tolerance;
+
+      // Write the data file.
+      dataFile << modes[m].GetUniqueName () << "\t" << maxError << "\t" << yansNs << "\t" << tableNs
+               << "\t" << yansNs / tableNs << std::endl;
+      std::cout << modes[m].GetUniqueName () << "\t" << maxError << "\t" << yansNs << "\t" << tableNs
+                << "\t" << yansNs / tableNs << std::endl;
+    }
+
+  /* The same scenario with both models. */
+  ExperimentResult results[2];
+  std::string errorModels[2] = { "yans", "table" };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      ExperimentConfig config = engine;
+      config.errorModel = errorModels[i];
+      ResetExperiment (config);
+      results[i] = RunExperiment (config);
+    }
+  dataFile << "# nWifi=" << engine.nWifi << ": yans " << results[0].wallTime << " s, " << results[0].throughput
+           << " Mbit/s, table " << results[1].wallTime << " s, " << results[1].throughput << " Mbit/s, "
+           << results[0].wallTime / results[1].wallTime << "x speedup" << std::endl;
+  std::cout << "# nWifi=" << engine.nWifi << ": yans " << results[0].wallTime << " s, " << results[0].throughput
+            << " Mbit/s, table " << results[1].wallTime << " s, " << results[1].throughput << " Mbit/s, "
+            << results[0].wallTime / results[1].wallTime << "x speedup" << std::endl;
+  // Close the data file.
+  dataFile.close ();
+
+  NS_ABORT_MSG_UNLESS (accurate, "The table differs from YansErrorRateModel by more than " << tolerance << " or returned NaN");
+  return 0;
+}
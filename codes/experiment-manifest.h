@@ -0,0 +1,393 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Manifest of one run: a sorted list of key=value entries describing
+ * everything the result depends on, and a 64 bit FNV-1a hash over them
+ * that names the run.
+ *
+ * The attribute part covers every attribute of every registered TypeId:
+ * their initial values are hashed (so any Config::SetDefault shows up in the
+ * hash) and those that differ from the compiled-in default are recorded as
+ * default.<TypeId>::<attribute> entries, together with the global values
+ * (RngSeed, RngRun, SchedulerType, ...) as global.<name> entries, so that
+ * ApplyDefaults () can put them back for a replay. Input files the run
+ * reads are recorded by size and digest as input.<name> entries.
+ *
+ * Entries under result. are what the run produced; they are kept in the
+ * file for comparison but are not part of the hash.
+ */
+
+#ifndef EXPERIMENT_MANIFEST_H
+#define EXPERIMENT_MANIFEST_H
+
+#include "ns3/core-module.h"
+#include <cerrno>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+inline uint64_t
+Fnv1a (const char *data, std::size_t size, uint64_t hash = 14695981039346656037ULL)
+{
+  for (std::size_t i = 0; i < size; i++)
+    {
+      hash ^= (uint8_t) data[i];
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+inline uint64_t
+Fnv1a (const std::string &data, uint64_t hash = 14695981039346656037ULL)
+{
+  return Fnv1a (data.data (), data.size (), hash);
+}
+
+/* The ns-3 build profile this program was compiled in. */
+inline std::string
+GetBuildProfile (void)
+{
+#if defined (NS3_BUILD_PROFILE_OPTIMIZED)
+  return "optimized";
+#elif defined (NS3_BUILD_PROFILE_RELEASE)
+  return "release";
+#elif defined (NS3_BUILD_PROFILE_DEBUG)
+  return "debug";
+#else
+  return "unknown";
+#endif
+}
+
+class ExperimentManifest
+{
+public:
+  template <typename T>
+  void Set (const std::string &key, const T &value);
+  std::string Get (const std::string &key) const;
+
+  /* Record the attribute defaults and global values as they are now. */
+  void AddAttributes (void);
+  /* Record the ns-3 version, build profile and compiler. */
+  void AddBuildInfo (void);
+  /* Record the size and FNV-1a digest of the contents of an input file as
+   * input.<name>, so that the hash changes with the file, not only with
+   * its name. The digest is read once per process for a given path, size
+   * and modification time, so the points of a sweep do not each read a
+   * large trace again. */
+  void AddInputFile (const std::string &name, const std::string &fileName);
+  /* Set the recorded default.* and global.* entries again. */
+  void ApplyDefaults (void) const;
+
+  /* The entries under prefix as --<name>=<value> command line arguments. */
+  std::vector<std::string> GetArguments (const std::string &prefix) const;
+  /* Keys whose values differ between the two manifests, or that only one
+   * has. A result.* key only one has was not measured by the other run (its
+   * counters were off) and is not a difference. */
+  std::vector<std::string> Compare (const ExperimentManifest &other) const;
+
+  /* 16 hex digits, over every entry but the result.* ones. */
+  std::string GetHash (void) const;
+  void Write (std::ostream &os) const;
+  /* Write to <directory>/<hash>.manifest, creating the directory, and
+   * return the file name. */
+  std::string Save (const std::string &directory) const;
+  static ExperimentManifest Load (const std::string &fileName);
+
+private:
+  static std::string Serialize (const AttributeValue &value, Ptr<const AttributeChecker> checker);
+  /* "size:digest" of the contents of a file. */
+  static std::string GetFileDigest (const std::string &fileName);
+
+  std::map<std::string, std::string> m_entries;
+};
+
+template <typename T>
+void
+ExperimentManifest::Set (const std::string &key, const T &value)
+{
+  std::ostringstream oss;
+  oss << std::boolalpha << std::setprecision (std::numeric_limits<double>::max_digits10) << value;
+  m_entries[key] = oss.str ();
+}
+
+std::string
+ExperimentManifest::Get (const std::string &key) const
+{
+  std::map<std::string, std::string>::const_iterator i = m_entries.find (key);
+  return i == m_entries.end () ? "" : i->second;
+}
+
+/* A value as a string that does not depend on where objects live in memory:
+ * a pointer becomes the ObjectFactory string of the object it points to,
+ * with the attributes of its own TypeId. */
+std::string
+ExperimentManifest::Serialize (const AttributeValue &value, Ptr<const AttributeChecker> checker)
+{
+  const PointerValue *pointer = dynamic_cast<const PointerValue *> (&value);
+  if (pointer == 0)
+    {
+      return value.SerializeToString (checker);
+    }
+  Ptr<Object> object = pointer->GetObject ();
+  if (object == 0)
+    {
+      return "0";
+    }
+  TypeId tid = object->GetInstanceTypeId ();
+  std::ostringstream oss;
+  oss << tid.GetName () << "[";
+  for (uint32_t i = 0, n = 0; i < tid.GetAttributeN (); i++)
+    {
+      struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+      Ptr<AttributeValue> attribute = info.checker->Create ();
+      if (!(info.flags & TypeId::ATTR_GET) || dynamic_cast<PointerValue *> (PeekPointer (attribute))
+          || !info.accessor->Get (PeekPointer (object), *attribute))
+        {
+          continue;
+        }
+      oss << (n++ ? "|" : "") << info.name << "=" << attribute->SerializeToString (info.checker);
+    }
+  oss << "]";
+  return oss.str ();
+}
+
+void
+ExperimentManifest::AddAttributes (void)
+{
+  uint64_t hash = Fnv1a ("");
+  for (uint32_t i = 0; i < TypeId::GetRegisteredN (); i++)
+    {
+      TypeId tid = TypeId::GetRegistered (i);
+      for (uint32_t j = 0; j < tid.GetAttributeN (); j++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (j);
+          std::string name = tid.GetName () + "::" + info.name;
+          std::string value = Serialize (*info.initialValue, info.checker);
+          hash = Fnv1a (name + "=" + value + "\n", hash);
+          if (value != Serialize (*info.originalInitialValue, info.checker))
+            {
+              m_entries["default." + name] = value;
+            }
+        }
+    }
+  for (GlobalValue::Iterator i = GlobalValue::Begin (); i != GlobalValue::End (); ++i)
+    {
+      Ptr<AttributeValue> value = (*i)->GetChecker ()->Create ();
+      (*i)->GetValue (*value);
+      m_entries["global." + (*i)->GetName ()] = Serialize (*value, (*i)->GetChecker ());
+    }
+  std::ostringstream oss;
+  oss << std::hex << std::setw (16) << std::setfill ('0') << hash;
+  m_entries["attributes.hash"] = oss.str ();
+}
+
+/* The VERSION file at the top of the ns-3 tree the running program was
+ * built in: the first one above the executable (build/<...>/program), so
+ * that it does not depend on the directory the program runs from. */
+inline std::string
+GetNs3Version (void)
+{
+  char exe[4096];
+  ssize_t length = readlink ("/proc/self/exe", exe, sizeof (exe) - 1);
+  if (length <= 0)
+    {
+      return "unknown";
+    }
+  std::string directory (exe, length);
+  for (std::string::size_type slash = directory.rfind ('/'); slash != std::string::npos && slash > 0;
+       slash = directory.rfind ('/'))
+    {
+      directory.erase (slash);
+      std::ifstream versionFile ((directory + "/VERSION").c_str ());
+      std::string version;
+      if (std::getline (versionFile, version))
+        {
+          return version;
+        }
+    }
+  return "unknown";
+}
+
+void
+ExperimentManifest::AddBuildInfo (void)
+{
+  m_entries["build.ns3"] = GetNs3Version ();
+  m_entries["build.profile"] = GetBuildProfile ();
+#if defined (__VERSION__)
+  m_entries["build.compiler"] = __VERSION__;
+#else
+  m_entries["build.compiler"] = "unknown";
+#endif
+}
+
+void
+ExperimentManifest::AddInputFile (const std::string &name, const std::string &fileName)
+{
+  m_entries["input." + name] = GetFileDigest (fileName);
+}
+
+std::string
+ExperimentManifest::GetFileDigest (const std::string &fileName)
+{
+  struct CachedDigest
+  {
+    off_t size;
+    struct timespec mtime;
+    std::string digest;
+  };
+  static std::map<std::string, CachedDigest> cache;
+
+  struct stat status;
+  NS_ABORT_MSG_UNLESS (stat (fileName.c_str (), &status) == 0, "Cannot read " << fileName);
+  std::map<std::string, CachedDigest>::const_iterator cached = cache.find (fileName);
+  if (cached != cache.end () && cached->second.size == status.st_size
+      && cached->second.mtime.tv_sec == status.st_mtim.tv_sec
+      && cached->second.mtime.tv_nsec == status.st_mtim.tv_nsec)
+    {
+      return cached->second.digest;
+    }
+
+  std::ifstream file (fileName.c_str (), std::ios::binary);
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Cannot read " << fileName);
+  uint64_t hash = Fnv1a ("");
+  uint64_t size = 0;
+  std::vector<char> block (65536);
+  while (file.read (&block[0], block.size ()) || file.gcount () > 0)
+    {
+      hash = Fnv1a (&block[0], file.gcount (), hash);
+      size += file.gcount ();
+    }
+  std::ostringstream oss;
+  oss << size << ":" << std::hex << std::setw (16) << std::setfill ('0') << hash;
+  CachedDigest entry;
+  entry.size = status.st_size;
+  entry.mtime = status.st_mtim;
+  entry.digest = oss.str ();
+  cache[fileName] = entry;
+  return entry.digest;
+}
+
+void
+ExperimentManifest::ApplyDefaults (void) const
+{
+  for (std::map<std::string, std::string>::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      if (i->first.compare (0, 8, "default.") == 0)
+        {
+          Config::SetDefault (i->first.substr (8), StringValue (i->second));
+        }
+      else if (i->first.compare (0, 7, "global.") == 0)
+        {
+          GlobalValue::Bind (i->first.substr (7), StringValue (i->second));
+        }
+    }
+}
+
+std::vector<std::string>
+ExperimentManifest::GetArguments (const std::string &prefix) const
+{
+  std::vector<std::string> arguments;
+  for (std::map<std::string, std::string>::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      if (i->first.compare (0, prefix.size (), prefix) == 0)
+        {
+          arguments.push_back ("--" + i->first.substr (prefix.size ()) + "=" + i->second);
+        }
+    }
+  return arguments;
+}
+
+std::vector<std::string>
+ExperimentManifest::Compare (const ExperimentManifest &other) const
+{
+  std::vector<std::string> keys;
+  for (std::map<std::string, std::string>::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      bool result = i->first.compare (0, 7, "result.") == 0;
+      std::map<std::string, std::string>::const_iterator j = other.m_entries.find (i->first);
+      if (j == other.m_entries.end () ? !result : j->second != i->second)
+        {
+          keys.push_back (i->first);
+        }
+    }
+  for (std::map<std::string, std::string>::const_iterator j = other.m_entries.begin (); j != other.m_entries.end (); ++j)
+    {
+      if (m_entries.find (j->first) == m_entries.end () && j->first.compare (0, 7, "result.") != 0)
+        {
+          keys.push_back (j->first);
+        }
+    }
+  return keys;
+}
+
+std::string
+ExperimentManifest::GetHash (void) const
+{
+  uint64_t hash = Fnv1a ("");
+  for (std::map<std::string, std::string>::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      if (i->first.compare (0, 7, "result.") != 0)
+        {
+          hash = Fnv1a (i->first + "=" + i->second + "\n", hash);
+        }
+    }
+  std::ostringstream oss;
+  oss << std::hex << std::setw (16) << std::setfill ('0') << hash;
+  return oss.str ();
+}
+
+void
+ExperimentManifest::Write (std::ostream &os) const
+{
+  os << "# manifest " << GetHash () << std::endl;
+  for (std::map<std::string, std::string>::const_iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      os << i->first << "=" << i->second << std::endl;
+    }
+}
+
+std::string
+ExperimentManifest::Save (const std::string &directory) const
+{
+  if (mkdir (directory.c_str (), 0755) < 0 && errno != EEXIST)
+    {
+      NS_FATAL_ERROR ("Cannot create manifest directory " << directory);
+    }
+  std::string fileName = directory + "/" + GetHash () + ".manifest";
+  std::ofstream file (fileName.c_str ());
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Cannot write manifest " << fileName);
+  Write (file);
+  return fileName;
+}
+
+ExperimentManifest
+ExperimentManifest::Load (const std::string &fileName)
+{
+  std::ifstream file (fileName.c_str ());
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Cannot read manifest " << fileName);
+  ExperimentManifest manifest;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::string::size_type equals = line.find ('=');
+      if (line.empty () || line[0] == '#' || equals == std::string::npos)
+        {
+          continue;
+        }
+      manifest.m_entries[line.substr (0, equals)] = line.substr (equals + 1);
+    }
+  return manifest;
+}
+
+} // namespace ns3
+
+#endif /* EXPERIMENT_MANIFEST_H */
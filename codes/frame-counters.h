@@ -0,0 +1,177 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Counters of the frames every wifi device puts on the air and of the
+ * transmissions that failed, hooked directly on the PHY and remote station
+ * manager trace sources of each device, and of the IPv4 fragments the
+ * nodes send.
+ *
+ * Airtime is estimated per frame as the 802.11b long PLCP preamble and
+ * header (192 us) plus the frame at the rate it was sent with.
+ */
+
+#ifndef FRAME_COUNTERS_H
+#define FRAME_COUNTERS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/internet-module.h"
+
+namespace ns3 {
+
+class FrameCounters
+{
+public:
+  FrameCounters ();
+
+  /* Hook the counters on every wifi device in the container. */
+  void Install (NetDeviceContainer devices);
+  /* Hook the IPv4 counters on every node in the container. */
+  void InstallIp (NodeContainer nodes);
+
+  uint64_t rtsFrames;                                /* RTS frames transmitted. */
+  uint64_t ctsFrames;                                /* CTS frames transmitted. */
+  uint64_t dataFrames;                               /* Data frames transmitted, retries included. */
+  uint64_t macFragments;                             /* Of which MAC fragments. */
+  uint64_t ackFrames;                                /* ACK frames transmitted. */
+  uint64_t otherFrames;                              /* Beacons and other management frames. */
+  double txAirtime;                                  /* Seconds on the air, all frames. */
+  double rtsCtsAirtime;                              /* Seconds on the air, RTS and CTS frames. */
+  uint64_t rtsFailed;                                /* RTS that got no CTS. */
+  uint64_t dataFailed;                               /* Data frames that got no ACK. */
+  uint64_t rxDrops;                                  /* Receptions lost to interference or noise. */
+  uint64_t ipFragments;                              /* IPv4 fragments sent. */
+  uint64_t ipReassemblyTimeouts;                     /* IPv4 packets dropped because a fragment never came. */
+
+private:
+  void MonitorSnifferTx (Ptr<const Packet> packet, uint16_t channelFreqMhz,
+                         WifiTxVector txVector, MpduInfo aMpdu);
+  void PhyRxDrop (Ptr<const Packet> packet);
+  void MacTxRtsFailed (Mac48Address address);
+  void MacTxDataFailed (Mac48Address address);
+  void Ipv4Tx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  void Ipv4Drop (const Ipv4Header &header, Ptr<const Packet> packet,
+                 Ipv4L3Protocol::DropReason reason, Ptr<Ipv4> ipv4, uint32_t interface);
+};
+
+FrameCounters::FrameCounters ()
+  : rtsFrames (0),
+    ctsFrames (0),
+    dataFrames (0),
+    macFragments (0),
+    ackFrames (0),
+    otherFrames (0),
+    txAirtime (0),
+    rtsCtsAirtime (0),
+    rtsFailed (0),
+    dataFailed (0),
+    rxDrops (0),
+    ipFragments (0),
+    ipReassemblyTimeouts (0)
+{
+}
+
+void
+FrameCounters::Install (NetDeviceContainer devices)
+{
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (*i);
+      device->GetPhy ()->TraceConnectWithoutContext ("MonitorSnifferTx", MakeCallback (&FrameCounters::MonitorSnifferTx, this));
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&FrameCounters::PhyRxDrop, this));
+      device->GetRemoteStationManager ()->TraceConnectWithoutContext ("MacTxRtsFailed", MakeCallback (&FrameCounters::MacTxRtsFailed, this));
+      device->GetRemoteStationManager ()->TraceConnectWithoutContext ("MacTxDataFailed", MakeCallback (&FrameCounters::MacTxDataFailed, this));
+    }
+}
+
+void
+FrameCounters::InstallIp (NodeContainer nodes)
+{
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      Ptr<Ipv4L3Protocol> ipv4 = (*i)->GetObject<Ipv4L3Protocol> ();
+      ipv4->TraceConnectWithoutContext ("Tx", MakeCallback (&FrameCounters::Ipv4Tx, this));
+      ipv4->TraceConnectWithoutContext ("Drop", MakeCallback (&FrameCounters::Ipv4Drop, this));
+    }
+}
+
+void
+FrameCounters::MonitorSnifferTx (Ptr<const Packet> packet, uint16_t channelFreqMhz,
+                                 WifiTxVector txVector, MpduInfo aMpdu)
+{
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  double airtime = 192e-6 + packet->GetSize () * 8.0 / txVector.GetMode ().GetDataRate (txVector);
+  txAirtime += airtime;
+  if (hdr.IsRts ())
+    {
+      rtsFrames++;
+      rtsCtsAirtime += airtime;
+    }
+  else if (hdr.IsCts ())
+    {
+      ctsFrames++;
+      rtsCtsAirtime += airtime;
+    }
+  else if (hdr.IsAck ())
+    {
+      ackFrames++;
+    }
+  else if (hdr.IsData ())
+    {
+      dataFrames++;
+      if (hdr.IsMoreFragments () || hdr.GetFragmentNumber () > 0)
+        {
+          macFragments++;
+        }
+    }
+  else
+    {
+      otherFrames++;
+    }
+}
+
+void
+FrameCounters::PhyRxDrop (Ptr<const Packet> packet)
+{
+  rxDrops++;
+}
+
+void
+FrameCounters::MacTxRtsFailed (Mac48Address address)
+{
+  rtsFailed++;
+}
+
+void
+FrameCounters::MacTxDataFailed (Mac48Address address)
+{
+  dataFailed++;
+}
+
+void
+FrameCounters::Ipv4Tx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ipv4Header hdr;
+  packet->PeekHeader (hdr);
+  if (!hdr.IsLastFragment () || hdr.GetFragmentOffset () > 0)
+    {
+      ipFragments++;
+    }
+}
+
+void
+FrameCounters::Ipv4Drop (const Ipv4Header &header, Ptr<const Packet> packet,
+                         Ipv4L3Protocol::DropReason reason, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  if (reason == Ipv4L3Protocol::DROP_FRAGMENT_TIMEOUT)
+    {
+      ipReassemblyTimeouts++;
+    }
+}
+
+} // namespace ns3
+
+#endif /* FRAME_COUNTERS_H */
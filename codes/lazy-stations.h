@@ -0,0 +1,165 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * STAs that only exist once they have traffic. Until Activate () a station
+ * is an index: no node, device, stack, mobility or application, so it
+ * schedules no events and does not receive beacons. Activate () builds it
+ * the way RunExperiment () builds every STA (same PHY, MAC, grid position,
+ * mobility model and IPv4 address as the eager scenario gives it) and hooks
+ * the counters on it; it may run before or during the simulation.
+ *
+ * Memory and events then follow the number of active stations, not nWifi.
+ */
+
+#ifndef LAZY_STATIONS_H
+#define LAZY_STATIONS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/traffic-control-module.h"
+#include "attribute-batch.h"
+#include "frame-counters.h"
+#include "rate-histogram.h"
+#include <vector>
+
+namespace ns3 {
+
+class LazyStations
+{
+public:
+  LazyStations ();
+
+  /* The helpers are copied as they are configured for the STAs.
+   * Without rootQueueDisc the default one is removed from every new device.
+   * phyAttributes, if not 0, is applied to every new PHY, the counters
+   * that are not 0 are hooked on every new station. */
+  void Setup (uint32_t nStations, WifiHelper wifi, YansWifiPhyHelper phy, WifiMacHelper mac,
+              InternetStackHelper stack, bool rootQueueDisc, const AttributeBatch *phyAttributes, Ipv4Address network, Ipv4Mask mask,
+              FrameCounters *frames, RateHistogram *rates);
+
+  /* Build the station if it does not exist yet and return its node. */
+  Ptr<Node> Activate (uint32_t station);
+
+  uint32_t GetNActive (void) const;
+  /* The active stations, in activation order. */
+  NodeContainer GetNodes (void) const;
+  NetDeviceContainer GetDevices (void) const;
+
+private:
+  std::vector<Ptr<Node> > m_stations;
+  NodeContainer m_nodes;
+  NetDeviceContainer m_devices;
+  WifiHelper m_wifi;
+  YansWifiPhyHelper m_phy;
+  WifiMacHelper m_mac;
+  const AttributeBatch *m_phyAttributes;
+  ObjectFactory m_mobility;
+  InternetStackHelper m_stack;
+  bool m_rootQueueDisc;
+  Ipv4Address m_network;
+  Ipv4Mask m_mask;
+  FrameCounters *m_frames;
+  RateHistogram *m_rates;
+};
+
+LazyStations::LazyStations ()
+  : m_phyAttributes (0),
+    m_rootQueueDisc (true),
+    m_frames (0),
+    m_rates (0)
+{
+}
+
+void
+LazyStations::Setup (uint32_t nStations, WifiHelper wifi, YansWifiPhyHelper phy, WifiMacHelper mac,
+                     InternetStackHelper stack, bool rootQueueDisc, const AttributeBatch *phyAttributes, Ipv4Address network, Ipv4Mask mask,
+                     FrameCounters *frames, RateHistogram *rates)
+{
+  m_stations.resize (nStations);
+  m_wifi = wifi;
+  m_phy = phy;
+  m_mac = mac;
+  m_stack = stack;
+  m_rootQueueDisc = rootQueueDisc;
+  m_phyAttributes = phyAttributes;
+  m_network = network;
+  m_mask = mask;
+  m_frames = frames;
+  m_rates = rates;
+  m_mobility.SetTypeId ("ns3::RandomDirection2dMobilityModel");
+  m_mobility.Set ("Bounds", RectangleValue (Rectangle (-500, 500, -500, 500)));
+  m_mobility.Set ("Speed", StringValue ("ns3::ConstantRandomVariable[Constant=2]"));
+  m_mobility.Set ("Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
+}
+
+Ptr<Node>
+LazyStations::Activate (uint32_t station)
+{
+  if (m_stations[station] != 0)
+    {
+      return m_stations[station];
+    }
+  Ptr<Node> node = CreateObject<Node> ();
+  NetDeviceContainer device = m_wifi.Install (m_phy, m_mac, node);
+  if (m_phyAttributes != 0)
+    {
+      m_phyAttributes->Apply (DynamicCast<WifiNetDevice> (device.Get (0))->GetPhy ());
+    }
+  if (m_frames != 0)
+    {
+      m_frames->Install (device);
+    }
+  if (m_rates != 0)
+    {
+      m_rates->Add (device.Get (0), station);
+    }
+
+  /* Where the grid of the eager scenario puts this station. */
+  Ptr<MobilityModel> mobility = m_mobility.Create<MobilityModel> ();
+  mobility->SetPosition (Vector (5.0 * (station % 3), 10.0 * (station / 3), 0));
+  node->AggregateObject (mobility);
+
+  m_stack.Install (node);
+  if (m_frames != 0)
+    {
+      m_frames->InstallIp (NodeContainer (node));
+    }
+  Ipv4AddressHelper address;
+  address.SetBase (m_network, m_mask, Ipv4Address (station + 1));
+  address.Assign (device);
+  if (!m_rootQueueDisc)
+    {
+      TrafficControlHelper ().Uninstall (device);
+    }
+
+  m_stations[station] = node;
+  m_nodes.Add (node);
+  m_devices.Add (device);
+  return node;
+}
+
+uint32_t
+LazyStations::GetNActive (void) const
+{
+  return m_nodes.GetN ();
+}
+
+NodeContainer
+LazyStations::GetNodes (void) const
+{
+  return m_nodes;
+}
+
+NetDeviceContainer
+LazyStations::GetDevices (void) const
+{
+  return m_devices;
+}
+
+} // namespace ns3
+
+#endif /* LAZY_STATIONS_H */
@@ -0,0 +1,119 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Memory of the scenario by subsystem: the bytes live in operator new (see
+ * pooled-allocator.h) are read between the setup steps, and what a step
+ * allocated and kept is charged to it. The run is charged with what it
+ * holds when it stops: packets queued in the sockets and MAC queues,
+ * routing and ARP state. Allocator and malloc overheads are not included.
+ */
+
+#ifndef MEMORY_FOOTPRINT_H
+#define MEMORY_FOOTPRINT_H
+
+#include "pooled-allocator.h"
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+class MemoryFootprint
+{
+public:
+  MemoryFootprint ();
+
+  /* Count from the live bytes now. */
+  void Start (void);
+  /* Charge the bytes allocated since the last Start () or Mark () to
+   * subsystem, added to what it was charged before. */
+  void Mark (const std::string &subsystem);
+
+  uint32_t GetNSubsystems (void) const;
+  const std::string &GetName (uint32_t i) const;
+  int64_t GetBytes (uint32_t i) const;
+  int64_t GetTotal (void) const;
+
+  /* One subsystem, bytes, bytes per station line per subsystem. */
+  void Write (std::ostream &os, uint32_t stations) const;
+
+private:
+  std::vector<std::pair<std::string, int64_t> > m_subsystems;
+  int64_t m_last;
+};
+
+MemoryFootprint::MemoryFootprint ()
+  : m_last (0)
+{
+}
+
+void
+MemoryFootprint::Start (void)
+{
+  m_subsystems.clear ();
+  m_last = PooledAllocator::GetStats ().liveBytes;
+}
+
+void
+MemoryFootprint::Mark (const std::string &subsystem)
+{
+  int64_t live = PooledAllocator::GetStats ().liveBytes;
+  int64_t bytes = live - m_last;
+  m_last = live;
+  for (uint32_t i = 0; i < m_subsystems.size (); i++)
+    {
+      if (m_subsystems[i].first == subsystem)
+        {
+          m_subsystems[i].second += bytes;
+          return;
+        }
+    }
+  m_subsystems.push_back (std::make_pair (subsystem, bytes));
+}
+
+uint32_t
+MemoryFootprint::GetNSubsystems (void) const
+{
+  return m_subsystems.size ();
+}
+
+const std::string &
+MemoryFootprint::GetName (uint32_t i) const
+{
+  return m_subsystems[i].first;
+}
+
+int64_t
+MemoryFootprint::GetBytes (uint32_t i) const
+{
+  return m_subsystems[i].second;
+}
+
+int64_t
+MemoryFootprint::GetTotal (void) const
+{
+  int64_t total = 0;
+  for (uint32_t i = 0; i < m_subsystems.size (); i++)
+    {
+      total += m_subsystems[i].second;
+    }
+  return total;
+}
+
+void
+MemoryFootprint::Write (std::ostream &os, uint32_t stations) const
+{
+  os << "subsystem" << "\t" << "bytes" << "\t" << "bytesPerSta" << std::endl;
+  for (uint32_t i = 0; i < m_subsystems.size (); i++)
+    {
+      os << m_subsystems[i].first << "\t" << m_subsystems[i].second << "\t"
+         << (stations > 0 ? (double) m_subsystems[i].second / stations : 0) << std::endl;
+    }
+  os << "total" << "\t" << GetTotal () << "\t" << (stations > 0 ? (double) GetTotal () / stations : 0) << std::endl;
+}
+
+} // namespace ns3
+
+#endif /* MEMORY_FOOTPRINT_H */
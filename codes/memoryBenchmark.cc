@@ -0,0 +1,111 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is a benchmark of the memory each STA costs, with and without
+ * --slimStations, and will output the results in a file called memoryBenchmark.dat
+ * and the bytes per STA of each subsystem in a file called memoryBenchmark-subsystems.dat.
+ * Use the following command to run:
+ * ./waf --run memoryBenchmark
+ *
+ * The saturated tcp-80211b scenario runs for nWifi = 100, 500 and 1000.
+ * We report the bytes per STA kept by the setup and by the run (see
+ * memory-footprint.h), the stations per GB they allow, the peak RSS and the
+ * throughput, and for each nWifi how many more STAs per GB slim STAs fit,
+ * whether that meets the target of twice as many, and what slim STAs cost
+ * in throughput: they are a different scenario, not a free saving.
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include "peak-rss.h"
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE ("memoryBenchmark");
+
+using namespace ns3;
+
+/* Slim STAs are meant to fit at least this many times more STAs per GB. */
+static const double STATIONS_PER_GB_TARGET = 2;
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", engine.simulationTime);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  const uint32_t nWifis[] = { 100, 500, 1000 };
+
+  // Create the data file.
+  std::string dataFileName = "memoryBenchmark.dat";
+  std::string subsystemFileName = "memoryBenchmark-subsystems.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  std::ofstream subsystemFile;
+  subsystemFile.open (subsystemFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "slimStations" << "\t" << "setupBytesPerSta" << "\t" << "runBytesPerSta"
+           << "\t" << "stationsPerGB" << "\t" << "peakRss" << "\t" << "throughput" << std::endl;
+  std::cout << "nWifi" << "\t" << "slimStations" << "\t" << "setupBytesPerSta" << "\t" << "runBytesPerSta"
+            << "\t" << "stationsPerGB" << "\t" << "peakRss" << "\t" << "throughput" << std::endl;
+  subsystemFile << "nWifi" << "\t" << "slimStations" << "\t" << "subsystem" << "\t" << "bytesPerSta" << std::endl;
+
+  for (uint32_t n = 0; n < sizeof (nWifis) / sizeof (nWifis[0]); n++)
+    {
+      double stationsPerGB[2] = { 0, 0 };
+      double throughput[2] = { 0, 0 };
+      for (uint32_t slim = 0; slim < 2; slim++)
+        {
+          ExperimentConfig config = engine;
+          config.nWifi = nWifis[n];
+          config.slimStations = slim;
+
+          /* Every point starts from the same state, so its manifest replays it. */
+          ResetExperiment (config);
+          ResetPeakRss ();
+          ExperimentResult result = RunExperiment (config);
+          double peakRss = GetPeakRss ();
+
+          double runBytes = 0;
+          double setupBytes = 0;
+          for (uint32_t i = 0; i < result.memory.GetNSubsystems (); i++)
+            {
+              double bytes = (double) result.memory.GetBytes (i) / config.nWifi;
+              if (result.memory.GetName (i) == "run")
+                {
+                  runBytes += bytes;
+                }
+              else
+                {
+                  setupBytes += bytes;
+                }
+              subsystemFile << config.nWifi << "\t" << slim << "\t" << result.memory.GetName (i) << "\t" << bytes << std::endl;
+            }
+          stationsPerGB[slim] = 1e9 / (setupBytes + runBytes);
+          throughput[slim] = result.throughput;
+
+          // Write the data file.
+          dataFile << config.nWifi << "\t" << slim << "\t" << setupBytes << "\t" << runBytes
+                   << "\t" << stationsPerGB[slim] << "\t" << peakRss << "\t" << result.throughput << std::endl;
+          std::cout << config.nWifi << "\t" << slim << "\t" << setupBytes << "\t" << runBytes
+                    << "\t" << stationsPerGB[slim] << "\t" << peakRss << "\t" << result.throughput << std::endl;
+        }
+      double gain = stationsPerGB[1] / stationsPerGB[0];
+      double throughputChange = throughput[0] > 0 ? (throughput[1] / throughput[0] - 1) * 100 : 0;
+      std::string target = gain >= STATIONS_PER_GB_TARGET ? "met" : "not met";
+      dataFile << "# nWifi=" << nWifis[n] << ": slimStations fit " << gain << "x more STAs per GB (target "
+               << STATIONS_PER_GB_TARGET << "x " << target << "), throughput " << throughput[0] << " -> "
+               << throughput[1] << " Mbit/s (" << throughputChange << "%)" << std::endl;
+      std::cout << "# nWifi=" << nWifis[n] << ": slimStations fit " << gain << "x more STAs per GB (target "
+                << STATIONS_PER_GB_TARGET << "x " << target << "), throughput " << throughput[0] << " -> "
+                << throughput[1] << " Mbit/s (" << throughputChange << "%)" << std::endl;
+    }
+  // Close the data file.
+  dataFile.close ();
+  subsystemFile.close ();
+  return 0;
+}
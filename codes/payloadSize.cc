@@ -4,6 +4,15 @@
  *
  * This is an experiment to test payloadSize over 802.11b 
  * and will output the results in a file called payloadSize.dat.
+ * Every payload size is run without RTS/CTS and with RTS/CTS for frames
+ * larger than 1000 bytes, the threshold is the rtsCtsThreshold column.
+ *
+ * Payloads over the 2244 bytes one 802.11 MSDU carries are fragmented by IP
+ * by default (--largePayloadMode=ip). With --largePayloadMode=mac the TCP
+ * segments are capped to one MSDU and the MAC fragments them according to
+ * --fragmentationThreshold, which must then be below the 2304 byte MSDU.
+ * The ipFragments and macFragments columns count the fragments sent either
+ * way.
  * Use the following command to run:
  * ./waf --run payloadSize
  *
@@ -20,168 +29,39 @@
  */
 
 #include "ns3/core-module.h"
-#include "ns3/network-module.h"
-#include "ns3/applications-module.h"
-#include "ns3/wifi-module.h"
-#include "ns3/mobility-module.h"
-#include "ns3/ipv4-global-routing-helper.h"
-#include "ns3/internet-module.h"
+#include "tcp-80211b-experiment.h"
 #include <fstream>
 
 NS_LOG_COMPONENT_DEFINE ("payloadSize");
 
 using namespace ns3;
 
-double experiment (uint32_t payloadSize, uint32_t nWifi, std::string dataRate, std::string tcpVariant, std::string phyRate)
+ExperimentResult experiment (const ExperimentConfig &engine, uint32_t payloadSize, uint32_t nWifi, std::string dataRate, std::string tcpVariant, std::string phyRate, uint32_t rtsCtsThreshold)
 {
-  double throughput = 0;
-  uint32_t totalPacketsThrough = 0;
-
-  double simulationTime = 1;                         /* Simulation time in seconds. */
-  bool pcapTracing = false;                          /* PCAP Tracing is enabled or not. */
-
-
-  /* No fragmentation */
-  Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("999999"));
-  
-  /* Disable RTS/CTS */
-  //Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("999999"));
-  /* Enable RTS/CTS for frames larger than 1000 */
-  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("1000"));
-
-
-  /* Configure TCP Options */
-  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (payloadSize));
-
-  WifiMacHelper wifiMac;
-  WifiHelper wifiHelper;
-  wifiHelper.SetStandard (WIFI_PHY_STANDARD_80211b);
-
-  /* Set up Legacy Channel */
-  YansWifiChannelHelper wifiChannel ;
-  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (5e9));
-
-  /* Setup Physical Layer */
-  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
-  wifiPhy.SetChannel (wifiChannel.Create ());
-  wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
-  wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
-  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
-  wifiPhy.Set ("TxGain", DoubleValue (0));
-  wifiPhy.Set ("RxGain", DoubleValue (0));
-  wifiPhy.Set ("RxNoiseFigure", DoubleValue (10));
-  wifiPhy.Set ("CcaMode1Threshold", DoubleValue (-79));
-  wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue (-79 + 3));
-  wifiPhy.SetErrorRateModel ("ns3::YansErrorRateModel");
-  wifiHelper.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
-                                      "DataMode", StringValue (phyRate),
-                                      "ControlMode", StringValue (phyRate));
-
-  NodeContainer wifiStaNodes;
-  wifiStaNodes.Create (nWifi);
-  NodeContainer wifiApNode;
-  wifiApNode.Create (1);
-
-  /* Configure AP */
-  Ssid ssid = Ssid ("network");
-  wifiMac.SetType ("ns3::ApWifiMac",
-                    "Ssid", SsidValue (ssid));
-
-  NetDeviceContainer apDevice;
-  apDevice = wifiHelper.Install (wifiPhy, wifiMac, wifiApNode);
-
-  /* Configure STA */
-  wifiMac.SetType ("ns3::StaWifiMac",
-                    "Ssid", SsidValue (ssid),
-                    "ActiveProbing", BooleanValue (false));
-
-  NetDeviceContainer staDevices;
-  staDevices = wifiHelper.Install (wifiPhy, wifiMac, wifiStaNodes);
-
-  /* Mobility model */
-  MobilityHelper mobility;
-
-  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
-                                 "MinX", DoubleValue (0.0),
-                                 "MinY", DoubleValue (0.0),
-                                 "DeltaX", DoubleValue (5.0),
-                                 "DeltaY", DoubleValue (10.0),
-                                 "GridWidth", UintegerValue (3),
-                                 "LayoutType", StringValue ("RowFirst"));
-
-  mobility.SetMobilityModel("ns3::RandomDirection2dMobilityModel",
-                              "Bounds", RectangleValue(Rectangle(-500, 500, -500, 500)),
-                              "Speed", StringValue ("ns3::ConstantRandomVariable[Constant=2]"),
-                              "Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
-
-  mobility.Install (wifiStaNodes);
-
-  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
-  mobility.Install (wifiApNode);
-
-
-  /* Internet stack */
-  InternetStackHelper stack;
-  stack.Install (wifiApNode);
-  stack.Install (wifiStaNodes);
-
-  Ipv4AddressHelper address;
-
-  address.SetBase ("192.168.1.0", "255.255.255.0");
-  Ipv4InterfaceContainer StaInterface;
-  StaInterface = address.Assign (staDevices);
-  Ipv4InterfaceContainer ApInterface;
-  ApInterface = address.Assign (apDevice);
-
-  /* Populate routing table */
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
-
-  /* Install TCP Receiver on the access point */
-  uint16_t port = 50000;
-  Address apLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
-  PacketSinkHelper packetSinkHelper ("ns3::TcpSocketFactory", apLocalAddress);
-      
-  ApplicationContainer sinkApp = packetSinkHelper.Install (wifiApNode.Get (0));
-  sinkApp.Start (Seconds (0.0));
-  sinkApp.Stop (Seconds (simulationTime + 1));
-
-  /* Install TCP Transmitter on the stations */
-  OnOffHelper onoff ("ns3::TcpSocketFactory",Ipv4Address::GetAny ());
-  onoff.SetAttribute ("OnTime",  StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-  onoff.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
-  onoff.SetAttribute ("PacketSize", UintegerValue (payloadSize));
-  onoff.SetAttribute ("DataRate", DataRateValue (DataRate (dataRate)));
-      
-  AddressValue remoteAddress (InetSocketAddress (ApInterface.GetAddress (0), port));
-  onoff.SetAttribute ("Remote", remoteAddress);
-      
-  ApplicationContainer apps;
-  apps.Add (onoff.Install (wifiStaNodes));
-  apps.Start (Seconds (1.0));
-  apps.Stop (Seconds (simulationTime + 1));
-
-  /* Enable Traces */
-  if (pcapTracing)
-    {
-      wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11_RADIO);
-      wifiPhy.EnablePcap ("AccessPoint", apDevice);
-      wifiPhy.EnablePcap ("Station", staDevices);
-    }
-
-  /* Start Simulation */
-  Simulator::Stop (Seconds (simulationTime + 1));
-  Simulator::Run ();
-  Simulator::Destroy ();
-
-  totalPacketsThrough = DynamicCast<PacketSink> (sinkApp.Get (0))->GetTotalRx ();
-  throughput = totalPacketsThrough * 8 / (simulationTime * 1000000.0);
-
-  return throughput;
+  ExperimentConfig config = engine;
+  config.payloadSize = payloadSize;
+  config.nWifi = nWifi;
+  config.dataRate = dataRate;
+  config.tcpVariant = tcpVariant;
+  config.phyRate = phyRate;
+  config.rtsCtsThreshold = rtsCtsThreshold;
+  config.countFrames = true;
+
+  /* Every point starts from the same state, whatever ran before it. */
+  ResetExperiment (config);
+  return RunExperiment (config);
 }
 
 int main (int argc, char *argv[])
 {
+  ExperimentConfig engine;
+  engine.largePayloadMode = "ip";
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("fragmentationThreshold", "Fragmentation threshold in bytes, 999999 disables fragmentation", engine.fragmentationThreshold);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
 
   /* Experiment with payload size. */
   // Create the data file.
@@ -189,23 +69,32 @@ int main (int argc, char *argv[])
   // Open the data file.
   std::ofstream dataFile;
   dataFile.open (dataFileName.c_str ());
-  dataFile << "nWifi" << "\t" << "payloadSize" << "\t" << "throughput" << std::endl;
-  std::cout << "nWifi" << "\t" << "payloadSize" << "\t" << "throughput" << std::endl;  
+  dataFile << "nWifi" << "\t" << "payloadSize" << "\t" << "rtsCtsThreshold" << "\t" << "throughput"
+           << "\t" << "ipFragments" << "\t" << "macFragments" << "\t" << "manifest" << std::endl;
+  std::cout << "nWifi" << "\t" << "payloadSize" << "\t" << "rtsCtsThreshold" << "\t" << "throughput"
+            << "\t" << "ipFragments" << "\t" << "macFragments" << "\t" << "manifest" << std::endl;
+
+  /* Disable RTS/CTS, then enable it for frames larger than 1000 */
+  const uint32_t rtsCtsThresholds[] = { 999999, 1000 };
 
   for (uint32_t nWifi = 1; nWifi <= 50; nWifi++)
   {
     for (uint32_t payloadSize = 1024; payloadSize <= 10240; payloadSize = payloadSize + 500)
     {
-    double throughput = 0;
+    for (uint32_t rts = 0; rts < 2; rts++)
+    {
     //uint32_t payloadSize = 1024;                     /* Transport layer payload size in bytes. */
     std::string dataRate = "100Mbps";                  /* Application layer datarate. */
     std::string tcpVariant = "ns3::TcpNewReno";        /* TCP variant type. */
     std::string phyRate = "DsssRate11Mbps";            /* Physical layer bitrate. */
-    throughput = experiment(payloadSize, nWifi, dataRate, tcpVariant, phyRate); 
+    ExperimentResult result = experiment (engine, payloadSize, nWifi, dataRate, tcpVariant, phyRate, rtsCtsThresholds[rts]); 
 
     // Write the data file.
-    dataFile << nWifi << "\t" << payloadSize <<"\t" << throughput << std::endl;
-    std::cout << nWifi << "\t" << payloadSize <<"\t" << throughput << std::endl;
+    dataFile << nWifi << "\t" << payloadSize << "\t" << rtsCtsThresholds[rts] <<"\t" << result.throughput
+             << "\t" << result.frames.ipFragments << "\t" << result.frames.macFragments << "\t" << result.manifest.GetHash () << std::endl;
+    std::cout << nWifi << "\t" << payloadSize << "\t" << rtsCtsThresholds[rts] <<"\t" << result.throughput
+              << "\t" << result.frames.ipFragments << "\t" << result.frames.macFragments << "\t" << result.manifest.GetHash () << std::endl;
+    }
     }
   }
   // Close the data file.
@@ -0,0 +1,47 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Peak resident set size of the process, for the benchmarks that report
+ * it per point. Only Linux /proc is needed.
+ */
+
+#ifndef PEAK_RSS_H
+#define PEAK_RSS_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace ns3 {
+
+/* Reset the peak RSS of the process to its current RSS (Linux >= 4.0). */
+inline void
+ResetPeakRss (void)
+{
+  std::ofstream clearRefs ("/proc/self/clear_refs");
+  clearRefs << "5";
+}
+
+/* Peak RSS of the process in MiB, from /proc/self/status. */
+inline double
+GetPeakRss (void)
+{
+  std::ifstream status ("/proc/self/status");
+  std::string line;
+  while (std::getline (status, line))
+    {
+      if (line.compare (0, 6, "VmHWM:") == 0)
+        {
+          std::istringstream value (line.substr (6));
+          double kiB = 0;
+          value >> kiB;
+          return kiB / 1024;
+        }
+    }
+  return 0;
+}
+
+} // namespace ns3
+
+#endif /* PEAK_RSS_H */
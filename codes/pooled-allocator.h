@@ -0,0 +1,253 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Replacement of the global operator new/delete that counts every
+ * allocation and, when pooling is enabled, serves small blocks (Packet,
+ * Buffer data, headers, tags, events, ...) from free lists refilled in
+ * chunks, so that a saturated run takes a new chunk only once per 64
+ * objects instead of calling malloc once per object.
+ *
+ * Pooling is off by default and switched with PooledAllocator::Enable ().
+ * Off, an allocation is a plain malloc and free plus a few counters, so the
+ * unpooled runs the benchmarks compare against pay no block header. The
+ * simulator and the programs that include this file run on one thread, so
+ * the counters and free lists are plain globals, with no locking and no
+ * atomics: a program that allocates from several threads must not include
+ * this file. Pooled blocks come from
+ * an address range reserved once, one region per size class, so delete
+ * tells them and their size class from their address. They are never
+ * given back to the system, they are recycled.
+ *
+ * This file defines the global operators: include it from exactly one
+ * translation unit of a program.
+ */
+
+#ifndef POOLED_ALLOCATOR_H
+#define POOLED_ALLOCATOR_H
+
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <stdint.h>
+#include <sys/mman.h>
+
+namespace ns3 {
+
+struct AllocationStats
+{
+  uint64_t allocations;                              /* Calls to operator new. */
+  uint64_t frees;                                    /* Calls to operator delete. */
+  uint64_t mallocCalls;                              /* Calls that reached malloc or took a new pool chunk. */
+  uint64_t pooled;                                   /* Allocations served from a free list. */
+  int64_t liveBytes;                                 /* Usable bytes allocated and not yet freed. */
+};
+
+class PooledAllocator
+{
+public:
+  /* Enabling reserves the pool address range the first time; if that
+   * fails, allocations keep going to malloc. */
+  static void Enable (bool enable);
+  static bool IsEnabled (void);
+  static AllocationStats GetStats (void);
+
+  static void * Allocate (std::size_t size);
+  static void Free (void *p);
+
+private:
+  static const uint32_t GRANULARITY = 16;
+  static const uint32_t SIZE_CLASSES = 32;           /* Pools blocks up to 512 bytes. */
+  static const uint32_t BLOCKS_PER_CHUNK = 64;
+  static const uint64_t REGION_SIZE = 1ull << 30;    /* Address space reserved per size class. */
+
+  static void * Refill (uint32_t sizeClass);
+
+  static bool s_enabled;
+  static char *s_arena;                              /* Region i - 1 holds the blocks of size class i. */
+  static uint64_t s_used[SIZE_CLASSES + 1];          /* Bytes handed out of each region. */
+  static void *s_freeLists[SIZE_CLASSES + 1];
+  static AllocationStats s_stats;
+};
+
+bool PooledAllocator::s_enabled = false;
+char *PooledAllocator::s_arena = 0;
+uint64_t PooledAllocator::s_used[PooledAllocator::SIZE_CLASSES + 1];
+void *PooledAllocator::s_freeLists[PooledAllocator::SIZE_CLASSES + 1];
+AllocationStats PooledAllocator::s_stats = { 0, 0, 0, 0, 0 };
+
+void
+PooledAllocator::Enable (bool enable)
+{
+  if (enable && s_arena == 0)
+    {
+      void *arena = mmap (0, SIZE_CLASSES * REGION_SIZE, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (arena == MAP_FAILED)
+        {
+          return;
+        }
+      s_arena = static_cast<char *> (arena);
+    }
+  s_enabled = enable;
+}
+
+bool
+PooledAllocator::IsEnabled (void)
+{
+  return s_enabled;
+}
+
+AllocationStats
+PooledAllocator::GetStats (void)
+{
+  return s_stats;
+}
+
+void *
+PooledAllocator::Refill (uint32_t sizeClass)
+{
+  std::size_t blockSize = sizeClass * GRANULARITY;
+  uint64_t offset = s_used[sizeClass];
+  if (offset + blockSize * BLOCKS_PER_CHUNK > REGION_SIZE)
+    {
+      return 0;
+    }
+  s_used[sizeClass] = offset + blockSize * BLOCKS_PER_CHUNK;
+  char *chunk = s_arena + (sizeClass - 1) * REGION_SIZE + offset;
+  /* Keep the first block for the caller, chain the others. */
+  for (uint32_t i = 1; i < BLOCKS_PER_CHUNK; i++)
+    {
+      void *block = chunk + i * blockSize;
+      *static_cast<void **> (block) = s_freeLists[sizeClass];
+      s_freeLists[sizeClass] = block;
+    }
+  return chunk;
+}
+
+void *
+PooledAllocator::Allocate (std::size_t size)
+{
+  s_stats.allocations++;
+  uint32_t sizeClass = size == 0 ? 1 : (size + GRANULARITY - 1) / GRANULARITY;
+  if (sizeClass <= SIZE_CLASSES && s_enabled)
+    {
+      void *block = s_freeLists[sizeClass];
+      if (block != 0)
+        {
+          s_freeLists[sizeClass] = *static_cast<void **> (block);
+          s_stats.pooled++;
+        }
+      else
+        {
+          block = Refill (sizeClass);
+          if (block != 0)
+            {
+              s_stats.mallocCalls++;
+            }
+        }
+      if (block != 0)
+        {
+          s_stats.liveBytes += sizeClass * GRANULARITY;
+          return block;
+        }
+      /* The region of this size class is full: use malloc. */
+    }
+  s_stats.mallocCalls++;
+  void *p = std::malloc (size == 0 ? 1 : size);
+  if (p != 0)
+    {
+      s_stats.liveBytes += (int64_t) malloc_usable_size (p);
+    }
+  return p;
+}
+
+void
+PooledAllocator::Free (void *p)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  s_stats.frees++;
+  char *block = static_cast<char *> (p);
+  if (s_arena != 0 && block >= s_arena && block < s_arena + SIZE_CLASSES * REGION_SIZE)
+    {
+      uint32_t sizeClass = (block - s_arena) / REGION_SIZE + 1;
+      s_stats.liveBytes -= sizeClass * GRANULARITY;
+      *static_cast<void **> (p) = s_freeLists[sizeClass];
+      s_freeLists[sizeClass] = p;
+      return;
+    }
+  s_stats.liveBytes -= (int64_t) malloc_usable_size (p);
+  std::free (p);
+}
+
+} // namespace ns3
+
+void *
+operator new (std::size_t size)
+{
+  void *p = ns3::PooledAllocator::Allocate (size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void *
+operator new[] (std::size_t size)
+{
+  return operator new (size);
+}
+
+void *
+operator new (std::size_t size, const std::nothrow_t &) noexcept
+{
+  return ns3::PooledAllocator::Allocate (size);
+}
+
+void *
+operator new[] (std::size_t size, const std::nothrow_t &) noexcept
+{
+  return ns3::PooledAllocator::Allocate (size);
+}
+
+void
+operator delete (void *p) noexcept
+{
+  ns3::PooledAllocator::Free (p);
+}
+
+void
+operator delete[] (void *p) noexcept
+{
+  ns3::PooledAllocator::Free (p);
+}
+
+void
+operator delete (void *p, std::size_t) noexcept
+{
+  ns3::PooledAllocator::Free (p);
+}
+
+void
+operator delete[] (void *p, std::size_t) noexcept
+{
+  ns3::PooledAllocator::Free (p);
+}
+
+void
+operator delete (void *p, const std::nothrow_t &) noexcept
+{
+  ns3::PooledAllocator::Free (p);
+}
+
+void
+operator delete[] (void *p, const std::nothrow_t &) noexcept
+{
+  ns3::PooledAllocator::Free (p);
+}
+
+#endif /* POOLED_ALLOCATOR_H */
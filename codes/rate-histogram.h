@@ -0,0 +1,151 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Per-station histogram of the rates the remote station manager picked for
+ * the data frames each station transmitted, retries included. The station
+ * is bound into the trace callback and the frames are counted per WifiMode
+ * uid, so a frame costs a header peek and an array increment; the mode
+ * names are only looked up for the report.
+ */
+
+#ifndef RATE_HISTOGRAM_H
+#define RATE_HISTOGRAM_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class RateHistogram
+{
+public:
+  /* Hook the histogram on every wifi device in the container, the first
+   * device is station 0. */
+  void Install (NetDeviceContainer devices);
+  /* Hook the histogram on one more device, as the given station. */
+  void Add (Ptr<NetDevice> device, uint32_t station);
+
+  uint32_t GetNStations (void) const;
+  /* Data frames per WifiMode name sent by one station. */
+  std::map<std::string, uint64_t> GetStation (uint32_t station) const;
+  /* Data frames per WifiMode name sent by all stations. */
+  std::map<std::string, uint64_t> GetTotal (void) const;
+
+  /* One "station mode frames" line per station and rate used. */
+  void Write (std::ostream &os) const;
+
+private:
+  static void MonitorSnifferTx (RateHistogram *histogram, uint32_t station, Ptr<const Packet> packet,
+                                uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu);
+
+  std::vector<std::vector<uint64_t> > m_stations;    /* Data frames per station and mode uid. */
+  std::vector<std::string> m_names;                  /* Name of each mode uid seen. */
+};
+
+void
+RateHistogram::Install (NetDeviceContainer devices)
+{
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Add (devices.Get (i), i);
+    }
+}
+
+void
+RateHistogram::Add (Ptr<NetDevice> device, uint32_t station)
+{
+  if (station >= m_stations.size ())
+    {
+      m_stations.resize (station + 1);
+    }
+  DynamicCast<WifiNetDevice> (device)->GetPhy ()
+    ->TraceConnectWithoutContext ("MonitorSnifferTx", MakeBoundCallback (&RateHistogram::MonitorSnifferTx, this, station));
+}
+
+uint32_t
+RateHistogram::GetNStations (void) const
+{
+  return m_stations.size ();
+}
+
+std::map<std::string, uint64_t>
+RateHistogram::GetStation (uint32_t station) const
+{
+  std::map<std::string, uint64_t> frames;
+  for (uint32_t uid = 0; uid < m_stations[station].size (); uid++)
+    {
+      if (m_stations[station][uid] > 0)
+        {
+          frames[m_names[uid]] = m_stations[station][uid];
+        }
+    }
+  return frames;
+}
+
+std::map<std::string, uint64_t>
+RateHistogram::GetTotal (void) const
+{
+  std::map<std::string, uint64_t> total;
+  for (uint32_t i = 0; i < m_stations.size (); i++)
+    {
+      for (uint32_t uid = 0; uid < m_stations[i].size (); uid++)
+        {
+          if (m_stations[i][uid] > 0)
+            {
+              total[m_names[uid]] += m_stations[i][uid];
+            }
+        }
+    }
+  return total;
+}
+
+void
+RateHistogram::Write (std::ostream &os) const
+{
+  os << "station" << "\t" << "mode" << "\t" << "frames" << std::endl;
+  for (uint32_t i = 0; i < m_stations.size (); i++)
+    {
+      std::map<std::string, uint64_t> frames = GetStation (i);
+      for (std::map<std::string, uint64_t>::const_iterator j = frames.begin (); j != frames.end (); ++j)
+        {
+          os << i << "\t" << j->first << "\t" << j->second << std::endl;
+        }
+    }
+}
+
+void
+RateHistogram::MonitorSnifferTx (RateHistogram *histogram, uint32_t station, Ptr<const Packet> packet,
+                                 uint16_t channelFreqMhz, WifiTxVector txVector, MpduInfo aMpdu)
+{
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  if (!hdr.IsData ())
+    {
+      return;
+    }
+  std::vector<uint64_t> &frames = histogram->m_stations[station];
+  uint32_t uid = txVector.GetMode ().GetUid ();
+  if (uid >= frames.size ())
+    {
+      frames.resize (uid + 1, 0);
+    }
+  if (uid >= histogram->m_names.size ())
+    {
+      histogram->m_names.resize (uid + 1);
+    }
+  if (histogram->m_names[uid].empty ())
+    {
+      histogram->m_names[uid] = txVector.GetMode ().GetUniqueName ();
+    }
+  frames[uid]++;
+}
+
+} // namespace ns3
+
+#endif /* RATE_HISTOGRAM_H */
@@ -0,0 +1,152 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * A population of STAs split into rate classes, each sending at its own
+ * constant DsssRate, e.g. "DsssRate1Mbps:0.1,DsssRate11Mbps:0.9" for 10% of
+ * the stations at 1 Mbit/s and the rest at 11 Mbit/s, and the throughput the
+ * access point received from each class.
+ *
+ * Stations are given to the classes in the order they are listed, the class
+ * sizes rounded by largest remainder so that they add up to nWifi.
+ */
+
+#ifndef RATE_MIX_H
+#define RATE_MIX_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+struct RateClass
+{
+  std::string mode;                                  /* WifiMode name the class sends at. */
+  double fraction = 0;                               /* Share of the stations. */
+  uint32_t stations = 0;                             /* Stations in the class. */
+  uint64_t rxBytes = 0;                              /* Bytes of the class the access point received. */
+};
+
+class RateMix
+{
+public:
+  /* Parse "<mode>:<fraction>,..."; the fractions are normalized to 1. */
+  void Parse (const std::string &mix);
+  /* Split nWifi stations over the classes. */
+  void Assign (uint32_t nWifi);
+  /* Count what the sink receives per class; interfaces holds the STA
+   * addresses in class order. */
+  void Install (Ipv4InterfaceContainer interfaces, Ptr<PacketSink> sink);
+
+  uint32_t GetNClasses (void) const;
+  const RateClass & GetClass (uint32_t i) const;
+
+private:
+  void Rx (Ptr<const Packet> packet, const Address &from);
+
+  std::vector<RateClass> m_classes;
+  std::map<Ipv4Address, uint32_t> m_addresses;
+};
+
+void
+RateMix::Parse (const std::string &mix)
+{
+  m_classes.clear ();
+  double sum = 0;
+  std::istringstream entries (mix);
+  std::string entry;
+  while (std::getline (entries, entry, ','))
+    {
+      std::string::size_type colon = entry.find (':');
+      RateClass rateClass;
+      rateClass.mode = entry.substr (0, colon);
+      rateClass.fraction = colon == std::string::npos ? -1 : std::atof (entry.substr (colon + 1).c_str ());
+      if (rateClass.mode.empty () || rateClass.fraction < 0)
+        {
+          NS_FATAL_ERROR ("Bad rateMix entry '" << entry << "', use <mode>:<fraction>,... e.g. DsssRate1Mbps:0.1,DsssRate11Mbps:0.9");
+        }
+      sum += rateClass.fraction;
+      m_classes.push_back (rateClass);
+    }
+  NS_ABORT_MSG_IF (sum <= 0, "rateMix " << mix << " has no stations");
+  for (std::vector<RateClass>::iterator i = m_classes.begin (); i != m_classes.end (); ++i)
+    {
+      i->fraction /= sum;
+    }
+}
+
+void
+RateMix::Assign (uint32_t nWifi)
+{
+  uint32_t assigned = 0;
+  std::vector<double> remainders;
+  for (std::vector<RateClass>::iterator i = m_classes.begin (); i != m_classes.end (); ++i)
+    {
+      double share = i->fraction * nWifi;
+      i->stations = std::floor (share);
+      remainders.push_back (share - i->stations);
+      assigned += i->stations;
+    }
+  /* Ties go to the class listed first. */
+  for (; assigned < nWifi; assigned++)
+    {
+      uint32_t largest = 0;
+      for (uint32_t i = 1; i < remainders.size (); i++)
+        {
+          if (remainders[i] > remainders[largest])
+            {
+              largest = i;
+            }
+        }
+      m_classes[largest].stations++;
+      remainders[largest] = -1;
+    }
+}
+
+void
+RateMix::Install (Ipv4InterfaceContainer interfaces, Ptr<PacketSink> sink)
+{
+  uint32_t station = 0;
+  for (uint32_t i = 0; i < m_classes.size (); i++)
+    {
+      for (uint32_t j = 0; j < m_classes[i].stations; j++)
+        {
+          m_addresses[interfaces.GetAddress (station++)] = i;
+        }
+    }
+  sink->TraceConnectWithoutContext ("Rx", MakeCallback (&RateMix::Rx, this));
+}
+
+uint32_t
+RateMix::GetNClasses (void) const
+{
+  return m_classes.size ();
+}
+
+const RateClass &
+RateMix::GetClass (uint32_t i) const
+{
+  return m_classes[i];
+}
+
+void
+RateMix::Rx (Ptr<const Packet> packet, const Address &from)
+{
+  std::map<Ipv4Address, uint32_t>::const_iterator i = m_addresses.find (InetSocketAddress::ConvertFrom (from).GetIpv4 ());
+  if (i != m_addresses.end ())
+    {
+      m_classes[i->second].rxBytes += packet->GetSize ();
+    }
+}
+
+} // namespace ns3
+
+#endif /* RATE_MIX_H */
@@ -0,0 +1,94 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is an experiment to test rate adaptation over 802.11b
+ * and will output the results in a file called rateManager.dat,
+ * and the rates the stations used in rateManager-histogram.dat.
+ * Use the following command to run:
+ * ./waf --run rateManager
+ *
+ * In this example, n wifi stations send TCP packets to the access point.
+ * We report the total throughput received by the access point during simulation time
+ * for ConstantRateWifiManager at 11 Mbps and the ARF, AARF, Minstrel and ideal
+ * managers, and the manager with the best throughput for each number of stations.
+ *
+ * Network topology:
+ *
+ *   STA        AP
+ *   *          *
+ *   |          |
+ *   nWifi      nWifi+1
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE ("rateManager");
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  uint32_t maxWifi = 50;
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("maxWifi", "Largest number of STA nodes", maxWifi);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  const std::string rateManagers[] = { "constant", "arf", "aarf", "minstrel", "ideal" };
+
+  /* Experiment with rate adaptation. */
+  // Create the data files.
+  std::string dataFileName = "rateManager.dat";
+  std::string histogramFileName = "rateManager-histogram.dat";
+  // Open the data files.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  std::ofstream histogramFile;
+  histogramFile.open (histogramFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "rateManager" << "\t" << "throughput" << "\t" << "manifest" << std::endl;
+  std::cout << "nWifi" << "\t" << "rateManager" << "\t" << "throughput" << "\t" << "manifest" << std::endl;
+  histogramFile << "nWifi" << "\t" << "rateManager" << "\t" << "mode" << "\t" << "frames" << std::endl;
+
+  for (uint32_t nWifi = 1; nWifi <= maxWifi; nWifi++)
+    {
+      std::string best;
+      double bestThroughput = -1;
+      for (uint32_t i = 0; i < sizeof (rateManagers) / sizeof (rateManagers[0]); i++)
+        {
+          ExperimentConfig config = engine;
+          config.nWifi = nWifi;
+          config.rateManager = rateManagers[i];
+          config.countRates = true;
+
+          /* Every point starts from the same state, whatever ran before it. */
+          ResetExperiment (config);
+          ExperimentResult result = RunExperiment (config);
+          if (result.throughput > bestThroughput)
+            {
+              bestThroughput = result.throughput;
+              best = rateManagers[i];
+            }
+
+          // Write the data files.
+          dataFile << nWifi << "\t" << rateManagers[i] << "\t" << result.throughput << "\t" << result.manifest.GetHash () << std::endl;
+          std::cout << nWifi << "\t" << rateManagers[i] << "\t" << result.throughput << "\t" << result.manifest.GetHash () << std::endl;
+          std::map<std::string, uint64_t> rates = result.rates.GetTotal ();
+          for (std::map<std::string, uint64_t>::const_iterator j = rates.begin (); j != rates.end (); ++j)
+            {
+              histogramFile << nWifi << "\t" << rateManagers[i] << "\t" << j->first << "\t" << j->second << std::endl;
+            }
+        }
+      std::cout << "# nWifi=" << nWifi << ": best rateManager " << best << " (" << bestThroughput << " Mbit/s)" << std::endl;
+    }
+  // Close the data files.
+  dataFile.close ();
+  histogramFile.close ();
+  return 0;
+}
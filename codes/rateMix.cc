@@ -0,0 +1,116 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is an experiment to quantify the 802.11b performance anomaly
+ * and will output the results in a file called rateMix.dat.
+ * Use the following command to run:
+ * ./waf --run rateMix
+ *
+ * In this example, n wifi stations send TCP packets to the access point,
+ * k of them at slowRate and the others at fastRate, for k = 0 .. nWifi.
+ * We report the total throughput received by the access point during simulation time
+ * and the throughput of each rate class.
+ *
+ * Under DCF every station gets about the same number of transmission
+ * opportunities, so the slow stations hold the medium for most of the time.
+ * With airtime fairness every station would get the same share of the
+ * airtime instead, and each class would get its share of stations times
+ * the throughput of a cell where every station sends at its rate:
+ *   airtimeFair = k/n * throughput(all slow) + (n-k)/n * throughput(all fast)
+ * The gain column is airtimeFair over the throughput DCF achieved.
+ *
+ * Network topology:
+ *
+ *   STA        AP
+ *   *          *
+ *   |          |
+ *   nWifi      nWifi+1
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include <fstream>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("rateMix");
+
+using namespace ns3;
+
+ExperimentResult experiment (const ExperimentConfig &engine, uint32_t slowStations, std::string slowRate, std::string fastRate)
+{
+  ExperimentConfig config = engine;
+  std::ostringstream rateMix;
+  rateMix << slowRate << ":" << slowStations << "," << fastRate << ":" << config.nWifi - slowStations;
+  config.rateMix = rateMix.str ();
+
+  /* Every point starts from the same state, whatever ran before it. */
+  ResetExperiment (config);
+  return RunExperiment (config);
+}
+
+/* Throughput of one rate class in Mbit/s. */
+double
+GetClassThroughput (const ExperimentConfig &config, const ExperimentResult &result, uint32_t rateClass)
+{
+  return result.rateMix.GetClass (rateClass).rxBytes * 8 / (config.simulationTime * 1000000.0);
+}
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  engine.nWifi = 10;
+  std::string slowRate = "DsssRate1Mbps";
+  std::string fastRate = "DsssRate11Mbps";
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("nWifi", "Number of STA nodes", engine.nWifi);
+  cmd.AddValue ("slowRate", "Rate of the slow stations", slowRate);
+  cmd.AddValue ("fastRate", "Rate of the fast stations", fastRate);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  /* The homogeneous cells, all fast and all slow, first: they are the
+   * references of the airtime fairness estimate. */
+  std::vector<ExperimentResult> results (engine.nWifi + 1);
+  results[0] = experiment (engine, 0, slowRate, fastRate);
+  results[engine.nWifi] = experiment (engine, engine.nWifi, slowRate, fastRate);
+  double fastAlone = results[0].throughput;
+  double slowAlone = results[engine.nWifi].throughput;
+
+  /* Experiment with the share of slow stations. */
+  // Create the data file.
+  std::string dataFileName = "rateMix.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "slowStations" << "\t" << "throughput" << "\t" << "slowThroughput" << "\t" << "fastThroughput"
+           << "\t" << "airtimeFair" << "\t" << "gain" << "\t" << "manifest" << std::endl;
+  std::cout << "nWifi" << "\t" << "slowStations" << "\t" << "throughput" << "\t" << "slowThroughput" << "\t" << "fastThroughput"
+            << "\t" << "airtimeFair" << "\t" << "gain" << "\t" << "manifest" << std::endl;
+
+  for (uint32_t slowStations = 0; slowStations <= engine.nWifi; slowStations++)
+    {
+      if (slowStations > 0 && slowStations < engine.nWifi)
+        {
+          results[slowStations] = experiment (engine, slowStations, slowRate, fastRate);
+        }
+      const ExperimentResult &result = results[slowStations];
+      double airtimeFair = (slowStations * slowAlone + (engine.nWifi - slowStations) * fastAlone) / engine.nWifi;
+
+      // Write the data file.
+      dataFile << engine.nWifi << "\t" << slowStations << "\t" << result.throughput
+               << "\t" << GetClassThroughput (engine, result, 0) << "\t" << GetClassThroughput (engine, result, 1)
+               << "\t" << airtimeFair << "\t" << (result.throughput > 0 ? airtimeFair / result.throughput : 0)
+               << "\t" << result.manifest.GetHash () << std::endl;
+      std::cout << engine.nWifi << "\t" << slowStations << "\t" << result.throughput
+                << "\t" << GetClassThroughput (engine, result, 0) << "\t" << GetClassThroughput (engine, result, 1)
+                << "\t" << airtimeFair << "\t" << (result.throughput > 0 ? airtimeFair / result.throughput : 0)
+                << "\t" << result.manifest.GetHash () << std::endl;
+    }
+  // Close the data file.
+  dataFile.close ();
+  return 0;
+}
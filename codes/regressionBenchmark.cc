@@ -0,0 +1,210 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is the simulation speed regression benchmark of the tcp-80211b
+ * scenario and will output the results in a file called regressionBenchmark.dat.
+ * Use the following command to run:
+ * ./waf --run regressionBenchmark
+ *
+ * A fixed matrix is run: nWifi 1, 10, 50 and 200, RTS/CTS off and on,
+ * pcap off and on. For every point we record the wall time, the events per
+ * second, the peak RSS and the simulated seconds per wall-clock second, the
+ * best of --repeats runs.
+ *
+ * The results are compared against a baseline recorded earlier on the same
+ * machine and build:
+ * ./waf --run "regressionBenchmark --updateBaseline=true"
+ * records regressionBenchmark-baseline-<profile>.dat, one per build profile.
+ * A later run fails (exit code 1) if any point is slower, or uses more
+ * memory, than the baseline by more than --threshold. Only Linux /proc is
+ * needed, no network.
+ *
+ * --reference=<file> reports the speedup over the results of another build,
+ * e.g. the optimized build over the debug one (see build-optimized.sh).
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include "peak-rss.h"
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("regressionBenchmark");
+
+using namespace ns3;
+
+struct BenchmarkPoint
+{
+  double wallTime;
+  double eventsPerSecond;
+  double peakRss;                                    /* MiB. */
+  double simSecondsPerWallSecond;
+};
+
+static std::string
+GetKey (uint32_t nWifi, bool rts, bool pcap)
+{
+  std::ostringstream key;
+  key << nWifi << "\t" << rts << "\t" << pcap;
+  return key.str ();
+}
+
+static std::map<std::string, BenchmarkPoint>
+ReadBaseline (const std::string &fileName)
+{
+  std::map<std::string, BenchmarkPoint> baseline;
+  std::ifstream file (fileName.c_str ());
+  std::string line;
+  std::getline (file, line);                         // Header.
+  while (std::getline (file, line))
+    {
+      std::istringstream fields (line);
+      uint32_t nWifi;
+      bool rts, pcap;
+      BenchmarkPoint point;
+      if (fields >> nWifi >> rts >> pcap >> point.wallTime >> point.eventsPerSecond >> point.peakRss >> point.simSecondsPerWallSecond)
+        {
+          baseline[GetKey (nWifi, rts, pcap)] = point;
+        }
+    }
+  return baseline;
+}
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  uint32_t repeats = 3;
+  double threshold = 0.1;
+  std::string baselineFileName = "regressionBenchmark-baseline-" + GetBuildProfile () + ".dat";
+  bool updateBaseline = false;
+  std::string referenceFileName = "";
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", engine.simulationTime);
+  cmd.AddValue ("repeats", "Runs per point, the fastest one counts", repeats);
+  cmd.AddValue ("threshold", "Relative slowdown or memory growth that counts as a regression", threshold);
+  cmd.AddValue ("baseline", "Baseline file to compare against or to update", baselineFileName);
+  cmd.AddValue ("updateBaseline", "Write this run as the new baseline instead of comparing", updateBaseline);
+  cmd.AddValue ("reference", "Results of another build to report the speedup over", referenceFileName);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  const uint32_t nWifiPoints[] = { 1, 10, 50, 200 };
+  std::cout << "# Build profile: " << GetBuildProfile () << std::endl;
+  std::map<std::string, BenchmarkPoint> baseline;
+  if (!updateBaseline)
+    {
+      baseline = ReadBaseline (baselineFileName);
+      if (baseline.empty ())
+        {
+          std::cout << "# No baseline in " << baselineFileName << ", run with --updateBaseline=true first" << std::endl;
+        }
+    }
+
+  // Create the data file.
+  std::string dataFileName = updateBaseline ? baselineFileName : "regressionBenchmark.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "rts" << "\t" << "pcap" << "\t" << "wallTime" << "\t" << "eventsPerSecond"
+           << "\t" << "peakRss" << "\t" << "simSecondsPerWallSecond" << std::endl;
+  std::cout << "nWifi" << "\t" << "rts" << "\t" << "pcap" << "\t" << "wallTime" << "\t" << "eventsPerSecond"
+            << "\t" << "peakRss" << "\t" << "simSecondsPerWallSecond" << std::endl;
+
+  std::map<std::string, BenchmarkPoint> reference;
+  if (referenceFileName != "")
+    {
+      reference = ReadBaseline (referenceFileName);
+    }
+
+  uint32_t regressions = 0;
+  double logSpeedup = 0;
+  uint32_t speedups = 0;
+  for (uint32_t i = 0; i < sizeof (nWifiPoints) / sizeof (nWifiPoints[0]); i++)
+    {
+      for (uint32_t rts = 0; rts < 2; rts++)
+        {
+          for (uint32_t pcap = 0; pcap < 2; pcap++)
+            {
+              ExperimentConfig config = engine;
+              config.nWifi = nWifiPoints[i];
+              config.rtsCtsThreshold = rts ? 0 : 999999;
+              config.pcapTracing = pcap;
+
+              BenchmarkPoint point;
+              point.wallTime = -1;
+              point.peakRss = 0;
+              for (uint32_t repeat = 0; repeat < repeats; repeat++)
+                {
+                  ResetExperiment (config);
+                  ResetPeakRss ();
+                  ExperimentResult result = RunExperiment (config);
+                  point.peakRss = std::max (point.peakRss, GetPeakRss ());
+                  if (point.wallTime < 0 || result.wallTime < point.wallTime)
+                    {
+                      point.wallTime = result.wallTime;
+                      point.eventsPerSecond = result.events / result.wallTime;
+                      point.simSecondsPerWallSecond = (config.simulationTime + 1) / result.wallTime;
+                    }
+                }
+
+              // Write the data file.
+              dataFile << config.nWifi << "\t" << rts << "\t" << pcap << "\t" << point.wallTime << "\t" << point.eventsPerSecond
+                       << "\t" << point.peakRss << "\t" << point.simSecondsPerWallSecond << std::endl;
+              std::cout << config.nWifi << "\t" << rts << "\t" << pcap << "\t" << point.wallTime << "\t" << point.eventsPerSecond
+                        << "\t" << point.peakRss << "\t" << point.simSecondsPerWallSecond << std::endl;
+
+              std::map<std::string, BenchmarkPoint>::const_iterator other = reference.find (GetKey (config.nWifi, rts, pcap));
+              if (other != reference.end ())
+                {
+                  double speedup = point.simSecondsPerWallSecond / other->second.simSecondsPerWallSecond;
+                  std::cout << "# nWifi=" << config.nWifi << " rts=" << rts << " pcap=" << pcap << ": "
+                            << speedup << "x over " << referenceFileName << std::endl;
+                  logSpeedup += std::log (speedup);
+                  speedups++;
+                }
+
+              std::map<std::string, BenchmarkPoint>::const_iterator base = baseline.find (GetKey (config.nWifi, rts, pcap));
+              if (base == baseline.end ())
+                {
+                  continue;
+                }
+              if (point.simSecondsPerWallSecond < base->second.simSecondsPerWallSecond * (1 - threshold))
+                {
+                  std::cout << "# REGRESSION nWifi=" << config.nWifi << " rts=" << rts << " pcap=" << pcap << ": "
+                            << point.simSecondsPerWallSecond << " simulated s per wall s, baseline "
+                            << base->second.simSecondsPerWallSecond << std::endl;
+                  regressions++;
+                }
+              if (point.peakRss > base->second.peakRss * (1 + threshold))
+                {
+                  std::cout << "# REGRESSION nWifi=" << config.nWifi << " rts=" << rts << " pcap=" << pcap << ": peak RSS "
+                            << point.peakRss << " MiB, baseline " << base->second.peakRss << " MiB" << std::endl;
+                  regressions++;
+                }
+            }
+        }
+    }
+  // Close the data file.
+  dataFile.close ();
+
+  if (speedups > 0)
+    {
+      std::cout << "# " << GetBuildProfile () << " build: " << std::exp (logSpeedup / speedups)
+                << "x over " << referenceFileName << " (geometric mean of " << speedups << " points)" << std::endl;
+    }
+  if (updateBaseline)
+    {
+      std::cout << "# Baseline written to " << baselineFileName << std::endl;
+      return 0;
+    }
+  if (!baseline.empty ())
+    {
+      std::cout << "# " << regressions << " regression(s) beyond " << threshold * 100 << "%" << std::endl;
+    }
+  return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is an experiment to test the RTS/CTS threshold over 802.11b
+ * and will output the results in a file called rtsThreshold.dat.
+ * Use the following command to run:
+ * ./waf --run rtsThreshold
+ *
+ * In this example, n wifi stations send TCP packets to the access point.
+ * We report the total throughput received by the access point during simulation time,
+ * the fraction of the airtime spent on RTS/CTS and the failed transmissions,
+ * and the threshold that maximises the throughput for each number of stations.
+ * On the default grid every STA hears every other one; --topology with
+ * --hiddenFraction places the STAs so that RTS/CTS has hidden terminals to
+ * protect against, and the hiddenPairs column reports their share.
+ *
+ * Network topology:
+ *
+ *   STA        AP
+ *   *          *
+ *   |          |
+ *   nWifi      nWifi+1
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE ("rtsThreshold");
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  uint32_t maxWifi = 50;
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("maxWifi", "Largest number of STA nodes", maxWifi);
+  cmd.AddValue ("payloadSize", "Payload size in bytes", engine.payloadSize);
+  cmd.AddValue ("fragmentationThreshold", "Fragmentation threshold in bytes, 999999 disables fragmentation", engine.fragmentationThreshold);
+  AddTopologyOptions (cmd, engine);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  /* RTS/CTS for every frame, for frames larger than the threshold, never. */
+  const uint32_t rtsCtsThresholds[] = { 0, 256, 512, 1000, 1500, 2000, 999999 };
+
+  /* Experiment with the RTS/CTS threshold. */
+  // Create the data file.
+  std::string dataFileName = "rtsThreshold.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "rtsCtsThreshold" << "\t" << "throughput" << "\t" << "rtsCtsOverhead"
+           << "\t" << "rtsFailed" << "\t" << "dataFailed" << "\t" << "rxDrops" << "\t" << "hiddenPairs" << "\t" << "manifest" << std::endl;
+  std::cout << "nWifi" << "\t" << "rtsCtsThreshold" << "\t" << "throughput" << "\t" << "rtsCtsOverhead"
+            << "\t" << "rtsFailed" << "\t" << "dataFailed" << "\t" << "rxDrops" << "\t" << "hiddenPairs" << "\t" << "manifest" << std::endl;
+
+  for (uint32_t nWifi = 1; nWifi <= maxWifi; nWifi++)
+    {
+      uint32_t best = 0;
+      double bestThroughput = -1;
+      for (uint32_t i = 0; i < sizeof (rtsCtsThresholds) / sizeof (rtsCtsThresholds[0]); i++)
+        {
+          ExperimentConfig config = engine;
+          config.nWifi = nWifi;
+          config.rtsCtsThreshold = rtsCtsThresholds[i];
+          config.countFrames = true;
+
+          /* Every point starts from the same state, whatever ran before it. */
+          ResetExperiment (config);
+          ExperimentResult result = RunExperiment (config);
+          if (result.throughput > bestThroughput)
+            {
+              bestThroughput = result.throughput;
+              best = rtsCtsThresholds[i];
+            }
+
+          // Write the data file.
+          dataFile << nWifi << "\t" << rtsCtsThresholds[i] << "\t" << result.throughput << "\t" << result.rtsCtsOverhead
+                   << "\t" << result.frames.rtsFailed << "\t" << result.frames.dataFailed << "\t" << result.frames.rxDrops << "\t" << result.topology.GetHiddenFraction () << "\t" << result.manifest.GetHash () << std::endl;
+          std::cout << nWifi << "\t" << rtsCtsThresholds[i] << "\t" << result.throughput << "\t" << result.rtsCtsOverhead
+                    << "\t" << result.frames.rtsFailed << "\t" << result.frames.dataFailed << "\t" << result.frames.rxDrops << "\t" << result.topology.GetHiddenFraction () << "\t" << result.manifest.GetHash () << std::endl;
+        }
+      std::cout << "# nWifi=" << nWifi << ": best rtsCtsThreshold " << best << " (" << bestThroughput << " Mbit/s)" << std::endl;
+    }
+  // Close the data file.
+  dataFile.close ();
+  return 0;
+}
@@ -0,0 +1,80 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is a benchmark of the event scheduler backends on the tcp-80211b
+ * scenario and will output the results in a file called schedulerBenchmark.dat.
+ * Use the following command to run:
+ * ./waf --run schedulerBenchmark
+ *
+ * For every number of STA nodes the same scenario is run once on each of the
+ * map, heap, calendar and list schedulers. We report the events executed per
+ * wall-clock second and the peak event set size, and the fastest backend for
+ * each nWifi so that SelectScheduler () can be kept in line with it.
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE ("schedulerBenchmark");
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  uint32_t maxWifi = 200;
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", engine.simulationTime);
+  cmd.AddValue ("maxWifi", "Largest number of STA nodes to benchmark", maxWifi);
+  cmd.Parse (argc, argv);
+
+  const uint32_t nWifiPoints[] = { 1, 5, 10, 20, 50, 100, 200, 500 };
+  const std::string schedulers[] = { "map", "heap", "calendar", "list" };
+
+  // Create the data file.
+  std::string dataFileName = "schedulerBenchmark.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "scheduler" << "\t" << "events" << "\t" << "eventsPerSecond"
+           << "\t" << "peakEventSetSize" << "\t" << "wallTime" << "\t" << "throughput" << std::endl;
+  std::cout << "nWifi" << "\t" << "scheduler" << "\t" << "events" << "\t" << "eventsPerSecond"
+            << "\t" << "peakEventSetSize" << "\t" << "wallTime" << "\t" << "throughput" << std::endl;
+
+  for (uint32_t i = 0; i < sizeof (nWifiPoints) / sizeof (nWifiPoints[0]) && nWifiPoints[i] <= maxWifi; i++)
+    {
+      std::string fastest;
+      double fastestRate = 0;
+      for (uint32_t j = 0; j < sizeof (schedulers) / sizeof (schedulers[0]); j++)
+        {
+          ExperimentConfig config = engine;
+          config.nWifi = nWifiPoints[i];
+          config.scheduler = schedulers[j];
+
+          /* Every point starts from the same state, so its manifest replays it. */
+          ResetExperiment (config);
+          ExperimentResult result = RunExperiment (config);
+          double eventsPerSecond = result.events / result.wallTime;
+          if (eventsPerSecond > fastestRate)
+            {
+              fastestRate = eventsPerSecond;
+              fastest = schedulers[j];
+            }
+
+          // Write the data file.
+          dataFile << config.nWifi << "\t" << schedulers[j] << "\t" << result.events << "\t" << eventsPerSecond
+                   << "\t" << result.peakEventSetSize << "\t" << result.wallTime << "\t" << result.throughput << std::endl;
+          std::cout << config.nWifi << "\t" << schedulers[j] << "\t" << result.events << "\t" << eventsPerSecond
+                    << "\t" << result.peakEventSetSize << "\t" << result.wallTime << "\t" << result.throughput << std::endl;
+        }
+      std::cout << "# nWifi=" << nWifiPoints[i] << ": fastest " << fastest
+                << ", auto selects " << SelectScheduler (nWifiPoints[i]) << std::endl;
+    }
+  // Close the data file.
+  dataFile.close ();
+  return 0;
+}
@@ -0,0 +1,80 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This is a benchmark of scenario construction time against the number of
+ * STA nodes and will output the results in a file called setupBenchmark.dat.
+ * Use the following command to run:
+ * ./waf --run setupBenchmark
+ *
+ * Every nWifi is built with the string based helper setup and with
+ * --typedSetup, each with and without the global routing database
+ * (--globalRouting). Only a very short simulation is run, we report the time
+ * spent building the scenario, in total and per STA, and for each nWifi the
+ * share of it that the typed attributes save with the routing database kept,
+ * and the share that skipping the routing database saves with the string
+ * based setup, so that neither gain is credited to the other.
+ */
+
+#include "ns3/core-module.h"
+#include "tcp-80211b-experiment.h"
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE ("setupBenchmark");
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  ExperimentConfig engine;
+  engine.simulationTime = 0.01;
+  uint32_t maxWifi = 2000;
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("maxWifi", "Largest number of STA nodes to build", maxWifi);
+  AddEngineOptions (cmd, engine);
+  cmd.Parse (argc, argv);
+
+  const uint32_t nWifiPoints[] = { 10, 50, 100, 200, 500, 1000, 2000, 5000 };
+
+  // Create the data file.
+  std::string dataFileName = "setupBenchmark.dat";
+  // Open the data file.
+  std::ofstream dataFile;
+  dataFile.open (dataFileName.c_str ());
+  dataFile << "nWifi" << "\t" << "typedSetup" << "\t" << "globalRouting" << "\t" << "setupTime" << "\t" << "setupTimePerSta" << std::endl;
+  std::cout << "nWifi" << "\t" << "typedSetup" << "\t" << "globalRouting" << "\t" << "setupTime" << "\t" << "setupTimePerSta" << std::endl;
+
+  for (uint32_t i = 0; i < sizeof (nWifiPoints) / sizeof (nWifiPoints[0]) && nWifiPoints[i] <= maxWifi; i++)
+    {
+      /* Setup time by typedSetup and globalRouting. */
+      double setupTime[2][2] = { { 0, 0 }, { 0, 0 } };
+      for (uint32_t routing = 0; routing < 2; routing++)
+        {
+          for (uint32_t typed = 0; typed < 2; typed++)
+            {
+              ExperimentConfig config = engine;
+              config.nWifi = nWifiPoints[i];
+              config.typedSetup = typed;
+              config.globalRouting = routing;
+              ResetExperiment (config);
+              ExperimentResult result = RunExperiment (config);
+              setupTime[typed][routing] = result.setupTime;
+
+              // Write the data file.
+              dataFile << config.nWifi << "\t" << typed << "\t" << routing << "\t" << result.setupTime << "\t" << result.setupTime / config.nWifi << std::endl;
+              std::cout << config.nWifi << "\t" << typed << "\t" << routing << "\t" << result.setupTime << "\t" << result.setupTime / config.nWifi << std::endl;
+            }
+        }
+      double typedGain = (1 - setupTime[1][1] / setupTime[0][1]) * 100;
+      double routingGain = (1 - setupTime[0][0] / setupTime[0][1]) * 100;
+      dataFile << "# nWifi=" << nWifiPoints[i] << ": typedSetup saves " << typedGain << "% of the setup time, "
+               << "skipping global routing " << routingGain << "%" << std::endl;
+      std::cout << "# nWifi=" << nWifiPoints[i] << ": typedSetup saves " << typedGain << "% of the setup time, "
+                << "skipping global routing " << routingGain << "%" << std::endl;
+    }
+  // Close the data file.
+  dataFile.close ();
+  return 0;
+}
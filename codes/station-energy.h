@@ -0,0 +1,227 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Energy and airtime accounting per STA: a BasicEnergySource and a
+ * WifiRadioEnergyModel on every station, the time each PHY spent in TX, RX,
+ * idle and CCA busy, and the bytes of each station the access point received.
+ *
+ * Everything is accumulated in counters, from the PHY state helper's State
+ * trace (once per state change, with the station bound into the callback)
+ * and the sink's Rx trace (once per packet), nothing is logged per event.
+ * The energy source is made large enough never to deplete and is not
+ * updated periodically, so the run itself is the same with or without the
+ * accounting.
+ */
+
+#ifndef STATION_ENERGY_H
+#define STATION_ENERGY_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/energy-module.h"
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+
+struct StationAirtime
+{
+  double tx = 0;                                     /* Seconds transmitting. */
+  double rx = 0;                                     /* Seconds receiving. */
+  double idle = 0;                                   /* Seconds idle. */
+  double ccaBusy = 0;                                /* Seconds sensing the medium busy. */
+  double other = 0;                                  /* Seconds switching channels or asleep. */
+  double energy = 0;                                 /* Joules the radio consumed. */
+  uint64_t rxBytes = 0;                              /* Bytes of this station the access point received. */
+};
+
+class StationEnergy
+{
+public:
+  /* Attach the energy model to every STA and hook the counters; the first
+   * device is station 0, interfaces holds the STA addresses in the same
+   * order. */
+  void Install (NodeContainer stations, NetDeviceContainer devices, Ipv4InterfaceContainer interfaces,
+                Ptr<PacketSink> sink, Time duration);
+  /* Close the counters once Simulator::Run () returned, before
+   * Simulator::Destroy (). */
+  void Finish (void);
+
+  uint32_t GetNStations (void) const;
+  const StationAirtime & GetStation (uint32_t station) const;
+  /* The sum over all stations. */
+  StationAirtime GetTotal (void) const;
+  /* Joules the stations consumed per bit the access point received. */
+  double GetJoulesPerBit (void) const;
+
+  /* One "station tx rx idle ccaBusy energy rxBytes joulesPerBit" line per station. */
+  void Write (std::ostream &os) const;
+
+private:
+  static void State (StationEnergy *energy, uint32_t station, Time start, Time duration, WifiPhy::State state);
+  void Rx (Ptr<const Packet> packet, const Address &from);
+  void Add (uint32_t station, double duration, WifiPhy::State state);
+
+  std::vector<StationAirtime> m_stations;
+  std::vector<Time> m_lastEnd;
+  std::vector<Ptr<WifiPhy> > m_phys;
+  std::vector<Ptr<DeviceEnergyModel> > m_models;
+  std::map<Ipv4Address, uint32_t> m_addresses;
+};
+
+void
+StationEnergy::Install (NodeContainer stations, NetDeviceContainer devices, Ipv4InterfaceContainer interfaces,
+                        Ptr<PacketSink> sink, Time duration)
+{
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Set ("BasicEnergySourceInitialEnergyJ", DoubleValue (1e9));
+  sourceHelper.Set ("PeriodicEnergyUpdateInterval", TimeValue (duration));
+  EnergySourceContainer sources = sourceHelper.Install (stations);
+  WifiRadioEnergyModelHelper radioHelper;
+  DeviceEnergyModelContainer models = radioHelper.Install (devices, sources);
+
+  m_stations.resize (devices.GetN ());
+  m_lastEnd.resize (devices.GetN ());
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<WifiPhy> phy = DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy ();
+      PointerValue state;
+      phy->GetAttribute ("State", state);
+      state.Get<WifiPhyStateHelper> ()
+        ->TraceConnectWithoutContext ("State", MakeBoundCallback (&StationEnergy::State, this, i));
+      m_phys.push_back (phy);
+      m_models.push_back (models.Get (i));
+      m_addresses[interfaces.GetAddress (i)] = i;
+    }
+  sink->TraceConnectWithoutContext ("Rx", MakeCallback (&StationEnergy::Rx, this));
+}
+
+void
+StationEnergy::Finish (void)
+{
+  /* The state a PHY is in is only reported once it ends. */
+  Time now = Simulator::Now ();
+  for (uint32_t i = 0; i < m_phys.size (); i++)
+    {
+      WifiPhy::State state = WifiPhy::SLEEP;
+      if (m_phys[i]->IsStateIdle ())
+        {
+          state = WifiPhy::IDLE;
+        }
+      else if (m_phys[i]->IsStateCcaBusy ())
+        {
+          state = WifiPhy::CCA_BUSY;
+        }
+      else if (m_phys[i]->IsStateTx ())
+        {
+          state = WifiPhy::TX;
+        }
+      else if (m_phys[i]->IsStateRx ())
+        {
+          state = WifiPhy::RX;
+        }
+      Add (i, (now - m_lastEnd[i]).GetSeconds (), state);
+      m_stations[i].energy = m_models[i]->GetTotalEnergyConsumption ();
+    }
+  m_phys.clear ();
+  m_models.clear ();
+}
+
+uint32_t
+StationEnergy::GetNStations (void) const
+{
+  return m_stations.size ();
+}
+
+const StationAirtime &
+StationEnergy::GetStation (uint32_t station) const
+{
+  return m_stations[station];
+}
+
+StationAirtime
+StationEnergy::GetTotal (void) const
+{
+  StationAirtime total;
+  for (std::vector<StationAirtime>::const_iterator i = m_stations.begin (); i != m_stations.end (); ++i)
+    {
+      total.tx += i->tx;
+      total.rx += i->rx;
+      total.idle += i->idle;
+      total.ccaBusy += i->ccaBusy;
+      total.other += i->other;
+      total.energy += i->energy;
+      total.rxBytes += i->rxBytes;
+    }
+  return total;
+}
+
+double
+StationEnergy::GetJoulesPerBit (void) const
+{
+  StationAirtime total = GetTotal ();
+  return total.rxBytes > 0 ? total.energy / (total.rxBytes * 8.0) : 0;
+}
+
+void
+StationEnergy::Write (std::ostream &os) const
+{
+  os << "station" << "\t" << "tx" << "\t" << "rx" << "\t" << "idle" << "\t" << "ccaBusy"
+     << "\t" << "energy" << "\t" << "rxBytes" << "\t" << "joulesPerBit" << std::endl;
+  for (uint32_t i = 0; i < m_stations.size (); i++)
+    {
+      const StationAirtime &s = m_stations[i];
+      os << i << "\t" << s.tx << "\t" << s.rx << "\t" << s.idle << "\t" << s.ccaBusy
+         << "\t" << s.energy << "\t" << s.rxBytes << "\t" << (s.rxBytes > 0 ? s.energy / (s.rxBytes * 8.0) : 0) << std::endl;
+    }
+}
+
+void
+StationEnergy::State (StationEnergy *energy, uint32_t station, Time start, Time duration, WifiPhy::State state)
+{
+  energy->Add (station, duration.GetSeconds (), state);
+  energy->m_lastEnd[station] = start + duration;
+}
+
+void
+StationEnergy::Rx (Ptr<const Packet> packet, const Address &from)
+{
+  std::map<Ipv4Address, uint32_t>::const_iterator i = m_addresses.find (InetSocketAddress::ConvertFrom (from).GetIpv4 ());
+  if (i != m_addresses.end ())
+    {
+      m_stations[i->second].rxBytes += packet->GetSize ();
+    }
+}
+
+void
+StationEnergy::Add (uint32_t station, double duration, WifiPhy::State state)
+{
+  StationAirtime &s = m_stations[station];
+  switch (state)
+    {
+    case WifiPhy::TX:
+      s.tx += duration;
+      break;
+    case WifiPhy::RX:
+      s.rx += duration;
+      break;
+    case WifiPhy::IDLE:
+      s.idle += duration;
+      break;
+    case WifiPhy::CCA_BUSY:
+      s.ccaBusy += duration;
+      break;
+    default:
+      s.other += duration;
+      break;
+    }
+}
+
+} // namespace ns3
+
+#endif /* STATION_ENERGY_H */
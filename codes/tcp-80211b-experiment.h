@@ -0,0 +1,896 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * The TCP over 802.11b scenario shared by tcp-80211b and the sweep
+ * experiments (phyRate, payloadSize, dataRate, tcpVariant, ...).
+ *
+ * n wifi stations send TCP packets to the access point and we report the
+ * total throughput received by the access point during simulation time.
+ *
+ * Network topology:
+ *
+ *   STA        AP
+ *   *          *
+ *   |          |
+ *   nWifi      nWifi+1
+ *
+ */
+
+#ifndef TCP_80211B_EXPERIMENT_H
+#define TCP_80211B_EXPERIMENT_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/internet-module.h"
+#include "ns3/traffic-control-module.h"
+#include "attribute-batch.h"
+#include "counting-scheduler.h"
+#include "dsss-error-rate-table.h"
+#include "experiment-manifest.h"
+#include "frame-counters.h"
+#include "lazy-stations.h"
+#include "memory-footprint.h"
+#include "pooled-allocator.h"
+#include "rate-histogram.h"
+#include "rate-mix.h"
+#include "station-energy.h"
+#include "telemetry-sampler.h"
+#include "throughput-series.h"
+#include "topology.h"
+#include "trace-replay.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/* Largest 802.11 MSDU in bytes. */
+static const uint32_t MAX_MSDU_SIZE = 2304;
+
+/* Largest TCP payload one MSDU carries without IP fragmentation: less
+ * LLC/SNAP (8), IPv4 (20) and a TCP header with the timestamp option (32). */
+static const uint32_t MAX_MSDU_PAYLOAD = MAX_MSDU_SIZE - 8 - 20 - 32;
+
+/* TCP send and receive buffers of slim stations: 16 segments of 1024
+ * bytes instead of 128 KiB, which a saturated STA keeps full. The sink on
+ * the AP keeps the default ones. */
+static const uint32_t SLIM_SOCKET_BUFFER = 16384;
+
+struct ExperimentConfig
+{
+  uint32_t nWifi = 50;                               /* Number of STA nodes. */
+  uint32_t payloadSize = 1024;                       /* Transport layer payload size in bytes. */
+  std::string dataRate = "100Mbps";                  /* Application layer datarate. */
+  std::string tcpVariant = "ns3::TcpNewReno";        /* TCP variant type. */
+  std::string phyRate = "DsssRate11Mbps";            /* Physical layer bitrate. */
+  std::string rateManager = "constant";              /* Rate adaptation: constant (at phyRate), arf, aarf, minstrel or ideal. */
+  std::string errorModel = "yans";                   /* DSSS chunk success rates: yans or table, see TabulatedDsssErrorRateModel. */
+  std::string rateMix = "";                          /* STA rate classes, e.g. DsssRate1Mbps:0.1,DsssRate11Mbps:0.9, see RateMix. */
+  double simulationTime = 1;                         /* Simulation time in seconds. */
+  std::string topology = "grid";                     /* STA placement: grid (moving, 5 GHz loss) or disk, ring, cluster, see Topology. */
+  double radius = 100;                               /* Radius of the disk, ring or cluster circle in metres. */
+  double hiddenFraction = -1;                        /* Share of hidden STA pairs the radius is chosen for, < 0 keeps radius. */
+  uint32_t clusters = 4;                             /* Clusters of the cluster topology. */
+  std::string trace = "";                            /* Packet trace the STAs replay instead of OnOff, see TraceReplay. */
+  bool lazyStations = false;                         /* Build STAs only once they have traffic, see LazyStations. */
+  double activeFraction = 1;                         /* Without a trace, the share of lazy STAs that sends. */
+  bool slimStations = false;                         /* IPv4 only, small socket buffers, no root queue disc on the STAs. */
+  bool pcapTracing = false;                          /* PCAP Tracing is enabled or not. */
+  uint32_t rtsCtsThreshold = 999999;                 /* Frames larger than this use RTS/CTS, 999999 disables it. */
+  uint32_t fragmentationThreshold = 999999;          /* Frames larger than this are fragmented, 999999 disables it. */
+  std::string largePayloadMode = "reject";           /* Payloads over MAX_MSDU_PAYLOAD: reject, ip or mac. */
+  std::string scheduler = "map";                     /* Event scheduler: map, heap, calendar, list or auto. */
+  bool packetPool = false;                           /* Serve small allocations from pooled free lists. */
+  uint32_t seed = 1;                                 /* RNG seed. */
+  uint64_t run = 1;                                  /* RNG run number. */
+  bool typedSetup = false;                           /* Build with pre-resolved attributes, see RunExperiment (). */
+  bool globalRouting = true;                         /* Populate the global routing database, which one subnet does not need. */
+  std::string telemetry = "";                        /* JSON Lines progress samples: file name or unix:<path>. */
+  double telemetryInterval = 0.1;                    /* Simulated seconds between telemetry samples. */
+  double seriesInterval = 0;                         /* Seconds per throughput series bin, 0 disables it. */
+  bool seriesPerStation = false;                     /* Also a throughput series per STA. */
+  std::string seriesFile = "";                       /* File the series is saved to, empty puts it next to the manifest. */
+  bool energy = false;                               /* Energy model and airtime accounting on every STA. */
+  bool countFrames = false;                          /* Count frames, failed transmissions and fragments, see FrameCounters. */
+  bool countRates = false;                           /* Count the data frames of each STA per rate, see RateHistogram. */
+  std::string manifestDir = "manifests";             /* Directory run manifests are saved to, empty disables it. */
+};
+
+struct ExperimentResult
+{
+  double throughput = 0;                             /* Mbit/s received by the access point. */
+  uint64_t totalRx = 0;                              /* Bytes received by the access point. */
+  std::string scheduler;                             /* Scheduler backend actually used. */
+  uint64_t events = 0;                               /* Events executed by the simulator. */
+  uint64_t peakEventSetSize = 0;                     /* Largest number of pending events. */
+  double setupTime = 0;                              /* Seconds spent building the scenario. */
+  double wallTime = 0;                               /* Seconds spent in Simulator::Run (). */
+  uint64_t allocations = 0;                          /* operator new calls during Simulator::Run (). */
+  uint64_t mallocCalls = 0;                          /* Of which reached malloc. */
+  MemoryFootprint memory;                            /* Bytes kept by each setup step and by the run. */
+  FrameCounters frames;                              /* Frames on the air and failed transmissions, with config.countFrames. */
+  double rtsCtsOverhead = 0;                         /* Fraction of the airtime spent on RTS and CTS. */
+  RateHistogram rates;                               /* Rates each STA sent its data frames at, with config.countRates. */
+  uint32_t activeStations = 0;                       /* STAs built, nWifi unless config.lazyStations. */
+  Topology topology;                                 /* Hearing range and hidden pairs, unless config.topology is grid. */
+  uint64_t traceRecords = 0;                         /* Trace packets sent, with config.trace. */
+  uint64_t traceSkipped = 0;                         /* Trace packets of stations beyond nWifi. */
+  RateMix rateMix;                                   /* Throughput per rate class, with config.rateMix. */
+  StationEnergy energy;                              /* Per STA airtime and energy, with config.energy. */
+  ThroughputSeries series;                           /* Throughput per bin, with config.seriesInterval. */
+  std::string seriesFile;                            /* Where the series was saved: config.seriesFile or next to the manifest. */
+  ExperimentManifest manifest;                       /* What the run depended on, see GetManifest (). */
+};
+
+/* Where the STAs are, see Topology. */
+inline void
+AddTopologyOptions (CommandLine &cmd, ExperimentConfig &config)
+{
+  cmd.AddValue ("topology", "STA placement: grid (the moving grid at 5 GHz), disk, ring or cluster (fixed STAs around the AP at 2.412 GHz)", config.topology);
+  cmd.AddValue ("radius", "Radius of the disk, ring or circle of clusters in metres", config.radius);
+  cmd.AddValue ("hiddenFraction", "Choose the radius so that this share of the STA pairs do not hear each other, < 0 keeps radius", config.hiddenFraction);
+  cmd.AddValue ("clusters", "Number of clusters of the cluster topology", config.clusters);
+}
+
+/* Options that define the scenario of one point. */
+inline void
+AddScenarioOptions (CommandLine &cmd, ExperimentConfig &config)
+{
+  cmd.AddValue ("nWifi", "Number of STA nodes", config.nWifi);
+  cmd.AddValue ("payloadSize", "Payload size in bytes", config.payloadSize);
+  cmd.AddValue ("dataRate", "Application data rate", config.dataRate);
+  cmd.AddValue ("tcpVariant", "Transport protocol to use: TcpTahoe, TcpReno, TcpNewReno, TcpWestwood, TcpWestwoodPlus ", config.tcpVariant);
+  cmd.AddValue ("phyRate", "Physical layer bitrate: DsssRate11Mbps, DsssRate5_5Mbps, DsssRate2Mbps, DsssRate1Mbps ", config.phyRate);
+  cmd.AddValue ("rateManager", "Rate adaptation: constant (at phyRate), arf, aarf, minstrel or ideal", config.rateManager);
+  cmd.AddValue ("errorModel", "Error rate model: yans (computed) or table (DSSS success rates interpolated from a table)", config.errorModel);
+  cmd.AddValue ("rateMix", "STA rate classes and their shares, e.g. DsssRate1Mbps:0.1,DsssRate11Mbps:0.9", config.rateMix);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", config.simulationTime);
+  AddTopologyOptions (cmd, config);
+  cmd.AddValue ("trace", "Replay the packets of this trace (.csv or binary) instead of saturated OnOff sources", config.trace);
+  cmd.AddValue ("lazyStations", "Build STAs only when their traffic starts: at their first trace record, or the first activeFraction of them", config.lazyStations);
+  cmd.AddValue ("activeFraction", "Without a trace, the share of lazy STAs that is built and sends", config.activeFraction);
+  cmd.AddValue ("slimStations", "Build STAs without IPv6, global routing or a root queue disc and with small socket buffers", config.slimStations);
+  cmd.AddValue ("pcap", "Enable/disable PCAP Tracing", config.pcapTracing);
+  cmd.AddValue ("rtsCtsThreshold", "RTS/CTS threshold in bytes, 999999 disables RTS/CTS", config.rtsCtsThreshold);
+  cmd.AddValue ("fragmentationThreshold", "Fragmentation threshold in bytes, 999999 disables fragmentation", config.fragmentationThreshold);
+}
+
+/* Options that apply to a single run and to every sweep alike. */
+inline void
+AddEngineOptions (CommandLine &cmd, ExperimentConfig &config)
+{
+  cmd.AddValue ("scheduler", "Event scheduler: map, heap, calendar, list or auto", config.scheduler);
+  cmd.AddValue ("packetPool", "Serve packets, buffers, headers and tags from pooled free lists", config.packetPool);
+  cmd.AddValue ("seed", "RNG seed", config.seed);
+  cmd.AddValue ("run", "RNG run number", config.run);
+  cmd.AddValue ("largePayloadMode", "Payloads too large for one MSDU: reject, ip (IP fragmentation) or mac (MSDU sized TCP segments, MAC fragmentation)", config.largePayloadMode);
+  cmd.AddValue ("telemetry", "Append JSON Lines progress samples to this file, or send them to unix:<path>", config.telemetry);
+  cmd.AddValue ("telemetryInterval", "Simulated seconds between telemetry samples", config.telemetryInterval);
+  cmd.AddValue ("seriesInterval", "Save the throughput of every bin of this many seconds next to the manifest, 0 disables it", config.seriesInterval);
+  cmd.AddValue ("seriesPerStation", "Add the throughput of each STA to the series", config.seriesPerStation);
+  cmd.AddValue ("seriesFile", "Save the series to this file instead, needed without a manifestDir", config.seriesFile);
+  cmd.AddValue ("typedSetup", "Build the scenario with pre-resolved attributes", config.typedSetup);
+  cmd.AddValue ("globalRouting", "Populate the global routing database, false keeps the connected routes of the one subnet only", config.globalRouting);
+  cmd.AddValue ("energy", "Attach an energy model to every STA and account its airtime and joules per delivered bit", config.energy);
+  cmd.AddValue ("countFrames", "Count the frames on the air, the failed transmissions and the IP and MAC fragments", config.countFrames);
+  cmd.AddValue ("countRates", "Count the data frames each STA sends at each rate", config.countRates);
+  cmd.AddValue ("manifestDir", "Directory to save run manifests to, empty disables them", config.manifestDir);
+}
+
+/* Everything the result of a point depends on: the configuration, under the
+ * names of its command line options, the attribute defaults and global
+ * values as they are now, and the build. Telemetry, the throughput series,
+ * the frame and rate counters and the manifest directory only observe a run
+ * and are left out. */
+inline ExperimentManifest
+GetManifest (const ExperimentConfig &config)
+{
+  ExperimentManifest manifest;
+  manifest.Set ("config.nWifi", config.nWifi);
+  manifest.Set ("config.payloadSize", config.payloadSize);
+  manifest.Set ("config.dataRate", config.dataRate);
+  manifest.Set ("config.tcpVariant", config.tcpVariant);
+  manifest.Set ("config.phyRate", config.phyRate);
+  manifest.Set ("config.rateManager", config.rateManager);
+  manifest.Set ("config.errorModel", config.errorModel);
+  manifest.Set ("config.rateMix", config.rateMix);
+  manifest.Set ("config.simulationTime", config.simulationTime);
+  manifest.Set ("config.topology", config.topology);
+  manifest.Set ("config.radius", config.radius);
+  manifest.Set ("config.hiddenFraction", config.hiddenFraction);
+  manifest.Set ("config.clusters", config.clusters);
+  manifest.Set ("config.trace", config.trace);
+  if (config.trace != "")
+    {
+      manifest.AddInputFile ("trace", config.trace);
+    }
+  manifest.Set ("config.lazyStations", config.lazyStations);
+  manifest.Set ("config.activeFraction", config.activeFraction);
+  manifest.Set ("config.slimStations", config.slimStations);
+  manifest.Set ("config.pcap", config.pcapTracing);
+  manifest.Set ("config.rtsCtsThreshold", config.rtsCtsThreshold);
+  manifest.Set ("config.fragmentationThreshold", config.fragmentationThreshold);
+  manifest.Set ("config.largePayloadMode", config.largePayloadMode);
+  manifest.Set ("config.scheduler", config.scheduler);
+  manifest.Set ("config.packetPool", config.packetPool);
+  manifest.Set ("config.seed", config.seed);
+  manifest.Set ("config.run", config.run);
+  manifest.Set ("config.typedSetup", config.typedSetup);
+  manifest.Set ("config.globalRouting", config.globalRouting);
+  manifest.Set ("config.energy", config.energy);
+  manifest.AddAttributes ();
+  manifest.AddBuildInfo ();
+  return manifest;
+}
+
+/* Parse the configuration recorded in a manifest over config, with the same
+ * options it came from. */
+inline void
+ReadManifestConfig (const ExperimentManifest &manifest, ExperimentConfig &config)
+{
+  CommandLine cmd;
+  AddScenarioOptions (cmd, config);
+  AddEngineOptions (cmd, config);
+  std::vector<std::string> arguments = manifest.GetArguments ("config.");
+  std::vector<char *> argv;
+  std::string program = "replay";
+  argv.push_back (&program[0]);
+  for (std::vector<std::string>::iterator i = arguments.begin (); i != arguments.end (); ++i)
+    {
+      argv.push_back (&(*i)[0]);
+    }
+  argv.push_back (0);
+  cmd.Parse (arguments.size () + 1, &argv[0]);
+}
+
+/* Bring the process back to the state the first experiment saw, so that
+ * back-to-back RunExperiment () calls in one process are isolated from each
+ * other. Simulator::Destroy () at the end of a run already drops the node,
+ * device and channel lists (and with them the node ids); what survives it
+ * is reset here. Note that Config::Reset () also drops defaults given on
+ * the command line as --ns3::... Mac48Address::Allocate () keeps counting
+ * across runs, nothing depends on the actual MAC address values in this
+ * scenario.
+ *
+ * This isolates the runs and nothing more. It does not make a sweep faster:
+ * every point still builds its scenario from scratch and tears it down with
+ * Simulator::Destroy (), and reusing a built scenario across points is not
+ * provided. */
+inline void
+ResetExperiment (const ExperimentConfig &config)
+{
+  Config::Reset ();
+  RngSeedManager::SetSeed (config.seed);
+  RngSeedManager::SetRun (config.run);
+  RngSeedManager::ResetNextStreamIndex ();
+  GlobalRouteManager::ResetRouterId ();
+  Ipv4AddressGenerator::Reset ();
+}
+
+/* The default value of a TcpSocket buffer attribute. */
+inline uint32_t
+GetTcpSocketDefault (const std::string &name)
+{
+  struct TypeId::AttributeInformation info;
+  NS_ABORT_MSG_UNLESS (TcpSocket::GetTypeId ().LookupAttributeByName (name, &info), "No attribute " << name << " in ns3::TcpSocket");
+  return DynamicCast<const UintegerValue> (info.initialValue)->Get ();
+}
+
+/* Buffers of the listening socket of the sink. The connections it accepts
+ * are copies of it, so they get the same. */
+inline void
+SetSocketBuffers (Ptr<PacketSink> sink, uint32_t sndBufSize, uint32_t rcvBufSize)
+{
+  Ptr<Socket> socket = sink->GetListeningSocket ();
+  socket->SetAttribute ("SndBufSize", UintegerValue (sndBufSize));
+  socket->SetAttribute ("RcvBufSize", UintegerValue (rcvBufSize));
+}
+
+/* Pick an event set backend from the number of events we expect to be
+ * pending at once: every STA keeps roughly a backoff, a timeout, an
+ * application and a mobility event alive, the AP its beacon. */
+inline std::string
+SelectScheduler (uint32_t nWifi)
+{
+  uint32_t expectedEvents = 4 * nWifi + 1;
+  if (expectedEvents < 32)
+    {
+      return "list";
+    }
+  return "heap";
+}
+
+inline TypeId
+GetSchedulerTypeId (const std::string &scheduler)
+{
+  if (scheduler == "map")
+    {
+      return MapScheduler::GetTypeId ();
+    }
+  else if (scheduler == "heap")
+    {
+      return HeapScheduler::GetTypeId ();
+    }
+  else if (scheduler == "calendar")
+    {
+      return CalendarScheduler::GetTypeId ();
+    }
+  else if (scheduler == "list")
+    {
+      return ListScheduler::GetTypeId ();
+    }
+  NS_FATAL_ERROR ("Unknown scheduler " << scheduler << ", use map, heap, calendar, list or auto");
+  return TypeId ();
+}
+
+/* The TCP segment size for the configured payload. In ip mode the segment
+ * is the payload and IP fragments what does not fit the device MTU. In mac
+ * mode the segment is capped to what one MSDU carries, the application still
+ * writes payloadSize bytes at a time and the MAC fragments frames larger than
+ * the fragmentation threshold, which must then be below the MSDU size: above
+ * it nothing is fragmented and the mode is plain TCP segmentation. */
+inline uint32_t
+GetSegmentSize (const ExperimentConfig &config)
+{
+  if (config.payloadSize == 0)
+    {
+      NS_FATAL_ERROR ("payloadSize must be at least 1 byte");
+    }
+  if (config.largePayloadMode != "reject" && config.largePayloadMode != "ip" && config.largePayloadMode != "mac")
+    {
+      NS_FATAL_ERROR ("Unknown largePayloadMode " << config.largePayloadMode << ", use reject, ip or mac");
+    }
+  if (config.payloadSize <= MAX_MSDU_PAYLOAD || config.largePayloadMode == "ip")
+    {
+      return config.payloadSize;
+    }
+  if (config.largePayloadMode == "mac")
+    {
+      NS_ABORT_MSG_IF (config.fragmentationThreshold >= MAX_MSDU_SIZE,
+                       "largePayloadMode=mac needs a fragmentationThreshold below the " << MAX_MSDU_SIZE
+                       << " byte MSDU, otherwise the MAC fragments nothing; got " << config.fragmentationThreshold);
+      return MAX_MSDU_PAYLOAD;
+    }
+  NS_FATAL_ERROR ("payloadSize " << config.payloadSize << " exceeds the " << MAX_MSDU_PAYLOAD
+                  << " bytes one 802.11 MSDU carries, use --largePayloadMode=ip or --largePayloadMode=mac");
+  return 0;
+}
+
+inline std::string
+GetRateManagerTypeName (const std::string &rateManager)
+{
+  if (rateManager == "constant")
+    {
+      return "ns3::ConstantRateWifiManager";
+    }
+  else if (rateManager == "arf")
+    {
+      return "ns3::ArfWifiManager";
+    }
+  else if (rateManager == "aarf")
+    {
+      return "ns3::AarfWifiManager";
+    }
+  else if (rateManager == "minstrel")
+    {
+      return "ns3::MinstrelWifiManager";
+    }
+  else if (rateManager == "ideal")
+    {
+      return "ns3::IdealWifiManager";
+    }
+  NS_FATAL_ERROR ("Unknown rateManager " << rateManager << ", use constant, arf, aarf, minstrel or ideal");
+  return "";
+}
+
+inline std::string
+GetErrorRateModelTypeName (const std::string &errorModel)
+{
+  if (errorModel == "yans")
+    {
+      return "ns3::YansErrorRateModel";
+    }
+  else if (errorModel == "table")
+    {
+      return "ns3::TabulatedDsssErrorRateModel";
+    }
+  NS_FATAL_ERROR ("Unknown errorModel " << errorModel << ", use yans or table");
+  return "";
+}
+
+inline ExperimentResult
+RunExperiment (const ExperimentConfig &config)
+{
+  ExperimentResult result;
+  std::chrono::steady_clock::time_point setupStart = std::chrono::steady_clock::now ();
+
+  NS_ABORT_MSG_IF (config.seriesInterval > 0 && config.seriesFile == "" && config.manifestDir == "",
+                   "seriesInterval needs a manifestDir to save the series next to, or a seriesFile");
+  PooledAllocator::Enable (config.packetPool);
+  RngSeedManager::SetSeed (config.seed);
+  RngSeedManager::SetRun (config.run);
+
+  /* Event scheduler, wrapped so that we can count events. */
+  result.scheduler = config.scheduler == "auto" ? SelectScheduler (config.nWifi) : config.scheduler;
+  ObjectFactory schedulerFactory;
+  schedulerFactory.SetTypeId (CountingScheduler::GetTypeId ());
+  schedulerFactory.Set ("Backend", TypeIdValue (GetSchedulerTypeId (result.scheduler)));
+  Simulator::SetScheduler (schedulerFactory);
+
+  /* Fragmentation of frames larger than the threshold, 999999 disables it */
+  Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", UintegerValue (config.fragmentationThreshold));
+
+  /* RTS/CTS for frames larger than the threshold, 999999 disables it */
+  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue (config.rtsCtsThreshold));
+
+  /* Configure TCP Options */
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (GetSegmentSize (config)));
+  /* Slim STAs get small socket buffers, the sink keeps the default ones:
+   * see SetSocketBuffers (). */
+  uint32_t sinkSndBufSize = GetTcpSocketDefault ("SndBufSize");
+  uint32_t sinkRcvBufSize = GetTcpSocketDefault ("RcvBufSize");
+  if (config.slimStations)
+    {
+      Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (SLIM_SOCKET_BUFFER));
+      Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (SLIM_SOCKET_BUFFER));
+    }
+
+  /* Every default is in place now, the helpers below derive from config.
+   * The manifest is not part of the setup time. */
+  std::chrono::steady_clock::time_point manifestStart = std::chrono::steady_clock::now ();
+  result.manifest = GetManifest (config);
+  setupStart += std::chrono::steady_clock::now () - manifestStart;
+  MemoryFootprint memory;
+  memory.Start ();
+
+  WifiMacHelper wifiMac;
+  WifiHelper wifiHelper;
+  wifiHelper.SetStandard (WIFI_PHY_STANDARD_80211b);
+
+  /* Set up Legacy Channel. The grid keeps the 5 GHz loss its results were
+   * recorded with, the other topologies use channel 1 of 802.11b. */
+  double frequency = config.topology == "grid" ? 5e9 : 2.412e9;
+  const double txPowerDbm = 10.0;
+  const double ccaThresholdDbm = -79;
+  const double detectionThresholdDbm = ccaThresholdDbm + 3;
+  YansWifiChannelHelper wifiChannel ;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (frequency));
+
+  Ptr<YansWifiChannel> channel = wifiChannel.Create ();
+
+  /* Setup Physical Layer */
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (channel);
+  AttributeBatch phyAttributes (WifiPhy::GetTypeId ());
+  phyAttributes.Add ("TxPowerStart", DoubleValue (txPowerDbm));
+  phyAttributes.Add ("TxPowerEnd", DoubleValue (txPowerDbm));
+  phyAttributes.Add ("TxPowerLevels", UintegerValue (1));
+  phyAttributes.Add ("TxGain", DoubleValue (0));
+  phyAttributes.Add ("RxGain", DoubleValue (0));
+  phyAttributes.Add ("RxNoiseFigure", DoubleValue (10));
+  phyAttributes.Add ("CcaMode1Threshold", DoubleValue (ccaThresholdDbm));
+  phyAttributes.Add ("EnergyDetectionThreshold", DoubleValue (detectionThresholdDbm));
+  if (!config.typedSetup)
+    {
+      phyAttributes.SetOn (wifiPhy);
+    }
+  wifiPhy.SetErrorRateModel (GetErrorRateModelTypeName (config.errorModel));
+  if (config.rateManager == "constant")
+    {
+      wifiHelper.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                          "DataMode", StringValue (config.phyRate),
+                                          "ControlMode", StringValue (config.phyRate));
+    }
+  else
+    {
+      wifiHelper.SetRemoteStationManager (GetRateManagerTypeName (config.rateManager));
+    }
+
+  /* Lazy STAs are built later, by LazyStations. */
+  NS_ABORT_MSG_IF (config.lazyStations && (config.rateMix != "" || config.energy || config.topology != "grid"),
+                   "lazyStations does not support rateMix, energy or a topology other than grid");
+  NS_ABORT_MSG_IF (config.activeFraction < 0 || config.activeFraction > 1, "activeFraction must be within [0, 1]");
+  memory.Mark ("channel");
+  NodeContainer wifiStaNodes;
+  wifiStaNodes.Create (config.lazyStations ? 0 : config.nWifi);
+  NodeContainer wifiApNode;
+  wifiApNode.Create (1);
+  memory.Mark ("nodes");
+
+  /* Configure AP */
+  Ssid ssid = Ssid ("network");
+  wifiMac.SetType ("ns3::ApWifiMac",
+                    "Ssid", SsidValue (ssid));
+
+  NetDeviceContainer apDevice;
+  apDevice = wifiHelper.Install (wifiPhy, wifiMac, wifiApNode);
+
+  /* Configure STA */
+  wifiMac.SetType ("ns3::StaWifiMac",
+                    "Ssid", SsidValue (ssid),
+                    "ActiveProbing", BooleanValue (false));
+
+  NetDeviceContainer staDevices;
+  RateMix rateMix;
+  if (config.rateMix != "")
+    {
+      /* One constant rate manager per rate class, the AP stays at phyRate. */
+      NS_ABORT_MSG_UNLESS (config.rateManager == "constant", "rateMix needs --rateManager=constant");
+      rateMix.Parse (config.rateMix);
+      rateMix.Assign (config.nWifi);
+      uint32_t first = 0;
+      for (uint32_t i = 0; i < rateMix.GetNClasses (); i++)
+        {
+          const RateClass &rateClass = rateMix.GetClass (i);
+          NodeContainer classNodes;
+          for (uint32_t j = first; j < first + rateClass.stations; j++)
+            {
+              classNodes.Add (wifiStaNodes.Get (j));
+            }
+          first += rateClass.stations;
+          wifiHelper.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                              "DataMode", StringValue (rateClass.mode),
+                                              "ControlMode", StringValue (rateClass.mode));
+          staDevices.Add (wifiHelper.Install (wifiPhy, wifiMac, classNodes));
+        }
+    }
+  else
+    {
+      staDevices = wifiHelper.Install (wifiPhy, wifiMac, wifiStaNodes);
+    }
+
+  /* With typed setup the PHY attributes go straight through their accessors. */
+  if (config.typedSetup)
+    {
+      phyAttributes.Apply (DynamicCast<WifiNetDevice> (apDevice.Get (0))->GetPhy ());
+      for (NetDeviceContainer::Iterator i = staDevices.Begin (); i != staDevices.End (); ++i)
+        {
+          phyAttributes.Apply (DynamicCast<WifiNetDevice> (*i)->GetPhy ());
+        }
+    }
+
+  memory.Mark ("wifi");
+
+  /* Counters cost a callback on every frame, only hook those that are read. */
+  FrameCounters frames;
+  if (config.countFrames)
+    {
+      frames.Install (apDevice);
+      frames.Install (staDevices);
+    }
+  RateHistogram rates;
+  if (config.countRates)
+    {
+      rates.Install (staDevices);
+    }
+  memory.Mark ("counters");
+
+  /* Mobility model */
+  Topology topology;
+  if (config.topology == "grid")
+    {
+      MobilityHelper mobility;
+
+      mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                     "MinX", DoubleValue (0.0),
+                                     "MinY", DoubleValue (0.0),
+                                     "DeltaX", DoubleValue (5.0),
+                                     "DeltaY", DoubleValue (10.0),
+                                     "GridWidth", UintegerValue (3),
+                                     "LayoutType", StringValue ("RowFirst"));
+
+      if (config.typedSetup)
+        {
+          Ptr<ConstantRandomVariable> speed = CreateObjectWithAttributes<ConstantRandomVariable> ("Constant", DoubleValue (2));
+          Ptr<ConstantRandomVariable> pause = CreateObjectWithAttributes<ConstantRandomVariable> ("Constant", DoubleValue (0.2));
+          mobility.SetMobilityModel("ns3::RandomDirection2dMobilityModel",
+                                      "Bounds", RectangleValue(Rectangle(-500, 500, -500, 500)),
+                                      "Speed", PointerValue (speed),
+                                      "Pause", PointerValue (pause));
+        }
+      else
+        {
+          mobility.SetMobilityModel("ns3::RandomDirection2dMobilityModel",
+                                      "Bounds", RectangleValue(Rectangle(-500, 500, -500, 500)),
+                                      "Speed", StringValue ("ns3::ConstantRandomVariable[Constant=2]"),
+                                      "Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
+        }
+
+      mobility.Install (wifiStaNodes);
+
+      mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+      mobility.Install (wifiApNode);
+    }
+  else
+    {
+      /* Fixed STAs around the AP, see Topology. */
+      Ptr<FriisPropagationLossModel> friis = CreateObjectWithAttributes<FriisPropagationLossModel> ("Frequency", DoubleValue (frequency));
+      topology.Generate (config.topology, config.nWifi, config.radius, config.hiddenFraction, config.clusters,
+                         friis, txPowerDbm, ccaThresholdDbm, detectionThresholdDbm);
+      topology.Install (wifiStaNodes, wifiApNode);
+    }
+  memory.Mark ("mobility");
+
+
+  /* Internet stack. Slim stations only get IPv4 and the connected routes of
+   * the one subnet. */
+  InternetStackHelper stack;
+  if (config.slimStations)
+    {
+      stack.SetIpv6StackInstall (false);
+      stack.SetRoutingHelper (Ipv4StaticRoutingHelper ());
+    }
+  stack.Install (wifiApNode);
+  stack.Install (wifiStaNodes);
+  if (config.countFrames)
+    {
+      frames.InstallIp (wifiApNode);
+      frames.InstallIp (wifiStaNodes);
+    }
+  memory.Mark ("internet");
+
+  Ipv4AddressHelper address;
+
+  /* One subnet for the whole cell, a /16 once a /24 cannot hold it. */
+  Ipv4Address network;
+  Ipv4Mask mask;
+  if (config.nWifi + 1 <= 254)
+    {
+      network = Ipv4Address ("192.168.1.0");
+      mask = Ipv4Mask ("255.255.255.0");
+    }
+  else
+    {
+      network = Ipv4Address ("10.1.0.0");
+      mask = Ipv4Mask ("255.255.0.0");
+    }
+  address.SetBase (network, mask);
+  Ipv4InterfaceContainer StaInterface;
+  StaInterface = address.Assign (staDevices);
+  /* Lazy STAs take their addresses when they are built, the AP the one after theirs. */
+  if (config.lazyStations)
+    {
+      address.SetBase (network, mask, Ipv4Address (config.nWifi + 1));
+    }
+  Ipv4InterfaceContainer ApInterface;
+  ApInterface = address.Assign (apDevice);
+  /* The STAs send through the MAC queue directly. */
+  TrafficControlHelper trafficControl;
+  if (config.slimStations)
+    {
+      trafficControl.Uninstall (staDevices);
+    }
+  memory.Mark ("addressing");
+
+  /* Populate routing table. Every node sits on the one wifi subnet, so the
+   * connected routes are all we need; building the global routing database
+   * is quadratic in the number of nodes and globalRouting=false skips it,
+   * as do lazy STAs, which are not there yet, and slim ones, which have no
+   * global routing. */
+  if (config.globalRouting && !config.lazyStations && !config.slimStations)
+    {
+      Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    }
+  memory.Mark ("routing");
+
+  /* Install TCP Receiver on the access point */
+  uint16_t port = 50000;
+  Address apLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
+  PacketSinkHelper packetSinkHelper ("ns3::TcpSocketFactory", apLocalAddress);
+
+  ApplicationContainer sinkApp = packetSinkHelper.Install (wifiApNode.Get (0));
+  sinkApp.Start (Seconds (0.0));
+  sinkApp.Stop (Seconds (config.simulationTime + 1));
+  if (config.slimStations)
+    {
+      /* At 1 s, after the sink listens and before the STA sources start. */
+      Simulator::Schedule (Seconds (1.0), &SetSocketBuffers, DynamicCast<PacketSink> (sinkApp.Get (0)),
+                           sinkSndBufSize, sinkRcvBufSize);
+    }
+
+  /* Lazy STAs: with a trace each one is built when its first record is due,
+   * otherwise the first activeFraction of them are built now and send. */
+  LazyStations lazy;
+  if (config.lazyStations)
+    {
+      lazy.Setup (config.nWifi, wifiHelper, wifiPhy, wifiMac, stack, !config.slimStations, config.typedSetup ? &phyAttributes : 0,
+                  network, mask, config.countFrames ? &frames : 0, config.countRates ? &rates : 0);
+      if (config.trace == "")
+        {
+          uint32_t active = std::ceil (config.activeFraction * config.nWifi);
+          for (uint32_t i = 0; i < active; i++)
+            {
+              lazy.Activate (i);
+            }
+          wifiStaNodes = lazy.GetNodes ();
+          staDevices = lazy.GetDevices ();
+        }
+    }
+
+  /* Install TCP Transmitter on the stations */
+  TraceReplay traceReplay;
+  if (config.trace != "" && config.lazyStations)
+    {
+      traceReplay.InstallLazy (config.trace, config.nWifi, MakeCallback (&LazyStations::Activate, &lazy),
+                               InetSocketAddress (ApInterface.GetAddress (0), port),
+                               Seconds (1.0), Seconds (config.simulationTime + 1));
+    }
+  else if (config.trace != "")
+    {
+      traceReplay.Install (config.trace, wifiStaNodes, InetSocketAddress (ApInterface.GetAddress (0), port),
+                           Seconds (1.0), Seconds (config.simulationTime + 1));
+    }
+  else
+    {
+      OnOffHelper onoff ("ns3::TcpSocketFactory",Ipv4Address::GetAny ());
+      onoff.SetAttribute ("OnTime",  StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      onoff.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      onoff.SetAttribute ("PacketSize", UintegerValue (config.payloadSize));
+      onoff.SetAttribute ("DataRate", DataRateValue (DataRate (config.dataRate)));
+
+      AddressValue remoteAddress (InetSocketAddress (ApInterface.GetAddress (0), port));
+      onoff.SetAttribute ("Remote", remoteAddress);
+
+      ApplicationContainer apps;
+      apps.Add (onoff.Install (wifiStaNodes));
+      apps.Start (Seconds (1.0));
+      apps.Stop (Seconds (config.simulationTime + 1));
+    }
+  memory.Mark ("applications");
+
+  if (config.rateMix != "")
+    {
+      rateMix.Install (StaInterface, DynamicCast<PacketSink> (sinkApp.Get (0)));
+    }
+
+  /* Energy and airtime accounting */
+  StationEnergy energy;
+  if (config.energy)
+    {
+      energy.Install (wifiStaNodes, staDevices, StaInterface, DynamicCast<PacketSink> (sinkApp.Get (0)),
+                      Seconds (config.simulationTime + 1));
+    }
+
+  /* Enable Traces */
+  if (config.pcapTracing)
+    {
+      wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11_RADIO);
+      wifiPhy.EnablePcap ("AccessPoint", apDevice);
+      wifiPhy.EnablePcap ("Station", staDevices);
+    }
+
+  /* Progress telemetry */
+  TelemetrySampler telemetry;
+  if (config.telemetry != "")
+    {
+      std::ostringstream label;
+      label << "\"nWifi\":" << config.nWifi << ",\"seed\":" << config.seed << ",\"run\":" << config.run << ",";
+      telemetry.Open (config.telemetry, label.str ());
+      NetDeviceContainer devices;
+      devices.Add (apDevice);
+      devices.Add (staDevices);
+      telemetry.Start (Seconds (config.telemetryInterval), DynamicCast<PacketSink> (sinkApp.Get (0)), devices);
+    }
+
+  /* Throughput series */
+  ThroughputSeries series;
+  if (config.seriesInterval > 0)
+    {
+      series.Install (DynamicCast<PacketSink> (sinkApp.Get (0)), Seconds (config.seriesInterval),
+                      Seconds (1.0), Seconds (config.simulationTime + 1), config.seriesPerStation, network, config.nWifi);
+    }
+
+  memory.Mark ("observers");
+
+  /* Start Simulation */
+  Simulator::Stop (Seconds (config.simulationTime + 1));
+  result.setupTime = std::chrono::duration<double> (std::chrono::steady_clock::now () - setupStart).count ();
+  AllocationStats allocStart = PooledAllocator::GetStats ();
+  std::chrono::steady_clock::time_point runStart = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  result.wallTime = std::chrono::duration<double> (std::chrono::steady_clock::now () - runStart).count ();
+  AllocationStats allocEnd = PooledAllocator::GetStats ();
+  memory.Mark ("run");
+  result.allocations = allocEnd.allocations - allocStart.allocations;
+  result.mallocCalls = allocEnd.mallocCalls - allocStart.mallocCalls;
+
+  CountingScheduler *scheduler = CountingScheduler::GetCurrent ();
+  result.events = scheduler->GetExecuted ();
+  result.peakEventSetSize = scheduler->GetPeakSize ();
+  result.totalRx = DynamicCast<PacketSink> (sinkApp.Get (0))->GetTotalRx ();
+  if (config.telemetry != "")
+    {
+      telemetry.Finish ();
+    }
+  if (config.energy)
+    {
+      energy.Finish ();
+    }
+  series.Finish ();
+  Simulator::Destroy ();
+
+  result.frames = frames;
+  result.rates = rates;
+  result.activeStations = config.lazyStations ? lazy.GetNActive () : config.nWifi;
+  result.traceRecords = traceReplay.GetRecords ();
+  result.traceSkipped = traceReplay.GetSkipped ();
+  result.rateMix = rateMix;
+  result.topology = topology;
+  result.memory = memory;
+  result.energy = energy;
+  result.series = series;
+  if (frames.txAirtime > 0)
+    {
+      result.rtsCtsOverhead = frames.rtsCtsAirtime / frames.txAirtime;
+    }
+
+  result.throughput = result.totalRx * 8 / (config.simulationTime * 1000000.0);
+
+  /* Everything the run produced that does not depend on the machine or on
+   * what ran before it in the process: times, allocations and memory do. */
+  result.manifest.Set ("result.totalRx", result.totalRx);
+  result.manifest.Set ("result.throughput", result.throughput);
+  result.manifest.Set ("result.events", result.events);
+  result.manifest.Set ("result.peakEventSetSize", result.peakEventSetSize);
+  result.manifest.Set ("result.activeStations", result.activeStations);
+  result.manifest.Set ("result.traceRecords", result.traceRecords);
+  result.manifest.Set ("result.traceSkipped", result.traceSkipped);
+  if (config.countFrames)
+    {
+      result.manifest.Set ("result.frames.rts", frames.rtsFrames);
+      result.manifest.Set ("result.frames.cts", frames.ctsFrames);
+      result.manifest.Set ("result.frames.data", frames.dataFrames);
+      result.manifest.Set ("result.frames.macFragments", frames.macFragments);
+      result.manifest.Set ("result.frames.ack", frames.ackFrames);
+      result.manifest.Set ("result.frames.other", frames.otherFrames);
+      result.manifest.Set ("result.frames.rtsFailed", frames.rtsFailed);
+      result.manifest.Set ("result.frames.dataFailed", frames.dataFailed);
+      result.manifest.Set ("result.frames.rxDrops", frames.rxDrops);
+      result.manifest.Set ("result.frames.ipFragments", frames.ipFragments);
+      result.manifest.Set ("result.frames.ipReassemblyTimeouts", frames.ipReassemblyTimeouts);
+      result.manifest.Set ("result.rtsCtsOverhead", result.rtsCtsOverhead);
+    }
+  std::map<std::string, uint64_t> rateTotals = rates.GetTotal ();
+  for (std::map<std::string, uint64_t>::const_iterator i = rateTotals.begin (); i != rateTotals.end (); ++i)
+    {
+      result.manifest.Set ("result.rates." + i->first, i->second);
+    }
+  for (uint32_t i = 0; i < rateMix.GetNClasses (); i++)
+    {
+      result.manifest.Set ("result.rateMix." + rateMix.GetClass (i).mode, rateMix.GetClass (i).rxBytes);
+    }
+  if (config.energy)
+    {
+      result.manifest.Set ("result.energy", energy.GetTotal ().energy);
+    }
+  std::string manifestFile;
+  if (config.manifestDir != "")
+    {
+      manifestFile = result.manifest.Save (config.manifestDir);
+    }
+  if (config.seriesInterval > 0)
+    {
+      /* seriesFile, or <hash>.series so that a sweep row finds its series
+       * through its manifest. */
+      result.seriesFile = config.seriesFile != "" ? config.seriesFile
+        : manifestFile.substr (0, manifestFile.size () - 9) + ".series";
+      std::ofstream seriesFile (result.seriesFile.c_str ());
+      NS_ABORT_MSG_UNLESS (seriesFile.is_open (), "Cannot write series " << result.seriesFile);
+      series.Write (seriesFile);
+    }
+  return result;
+}
+
+} // namespace ns3
+
+#endif /* TCP_80211B_EXPERIMENT_H */
@@ -18,7 +18,46 @@
  * 5. physical layer transmission rate, i.e. four different data rates of 1, 2, 5.5 or 11 Mbps
  *    (Example: ./waf --run "tcp-80211b --"DsssRate5_5Mbps""),
  * 6. simulation time (Example: ./waf --run "tcp-80211b --simulationTime=10"),
- * 7. enable/disable pcap tracing (Example: ./waf --run "tcp-80211b --pcapTracing=true").
+ * 7. enable/disable pcap tracing (Example: ./waf --run "tcp-80211b --pcapTracing=true"),
+ * 8. event scheduler: map, heap, calendar, list or auto (Example: ./waf --run "tcp-80211b --scheduler=heap"),
+ * 9. pooled allocation of packets, buffers, headers and tags (Example: ./waf --run "tcp-80211b --packetPool=true"),
+ * 10. RNG seed and run number (Example: ./waf --run "tcp-80211b --seed=3 --run=7"),
+ * 11. run the scenario twice with ResetExperiment () in between and check that both runs
+ *     have identical manifests, results included (Example: ./waf --run "tcp-80211b --checkReset=true"),
+ * 12. build the scenario with pre-resolved attributes, and skip the global routing database
+ *     (Example: ./waf --run "tcp-80211b --typedSetup=true --globalRouting=false"),
+ * 13. RTS/CTS threshold in bytes, 999999 disables RTS/CTS (Example: ./waf --run "tcp-80211b --rtsCtsThreshold=1000"),
+ * 14. fragmentation threshold in bytes, 999999 disables fragmentation
+ *     (Example: ./waf --run "tcp-80211b --fragmentationThreshold=1000"),
+ * 15. what to do with payloads larger than one 802.11 MSDU carries (2244 bytes): reject them,
+ *     let IP fragment them, or cap TCP segments to one MSDU and let the MAC fragment
+ *     (Example: ./waf --run "tcp-80211b --payloadSize=8000 --largePayloadMode=mac --fragmentationThreshold=1000"),
+ * 16. rate adaptation: constant (at phyRate), arf, aarf, minstrel or ideal, and a file for the
+ *     per-station histogram of the rates used (Example: ./waf --run "tcp-80211b --rateManager=minstrel --rateHistogram=rates.dat"),
+ * 17. JSON Lines progress telemetry appended to a file or sent to a Unix socket
+ *     (Example: ./waf --run "tcp-80211b --telemetry=progress.jsonl --telemetryInterval=1"),
+ * 18. directory the run manifest is saved to, and replay of the point a saved manifest describes
+ *     (Example: ./waf --run "tcp-80211b --replay=manifests/0123456789abcdef.manifest"),
+ * 19. energy model and TX/RX/idle/CCA busy airtime per STA, and a file for the per-station report
+ *     (Example: ./waf --run "tcp-80211b --energy=true --energyReport=energy.dat"),
+ * 20. STA rate classes, each at its own constant rate, and the throughput of each class
+ *     (Example: ./waf --run "tcp-80211b --nWifi=10 --rateMix=DsssRate1Mbps:0.1,DsssRate11Mbps:0.9"),
+ * 21. replay the packets of a trace instead of saturated OnOff sources, see trace-replay.h
+ *     (Example: ./waf --run "tcp-80211b --trace=traffic.csv --simulationTime=60"),
+ * 22. build STAs only when their traffic starts: at their first trace record, or the first
+ *     activeFraction of them without a trace
+ *     (Example: ./waf --run "tcp-80211b --nWifi=5000 --lazyStations=true --trace=traffic.trace"),
+ * 23. DSSS chunk success rates interpolated from a table instead of computed, see dsss-error-rate-table.h
+ *     (Example: ./waf --run "tcp-80211b --nWifi=200 --errorModel=table"),
+ * 24. fixed STAs in a disk, ring or clusters around the AP, with the radius chosen for a share of
+ *     hidden STA pairs, and a file for the positions and hear-ability, see topology.h
+ *     (Example: ./waf --run "tcp-80211b --topology=disk --hiddenFraction=0.2 --topologyReport=topology.dat"),
+ * 25. slim STAs: no IPv6, global routing or root queue disc and small socket buffers on the STAs,
+ *     and a file for the memory each subsystem keeps, see memory-footprint.h
+ *     (Example: ./waf --run "tcp-80211b --nWifi=1000 --slimStations=true --memoryReport=memory.dat"),
+ * 26. throughput in bins of seriesInterval seconds, of the cell and optionally of each STA, saved
+ *     next to the manifest as <hash>.series or to seriesFile, see throughput-series.h
+ *     (Example: ./waf --run "tcp-80211b --nWifi=200 --seriesInterval=0.01 --seriesPerStation=true").
  *
  * Network topology:
  *
@@ -30,13 +69,8 @@
  */
 
 #include "ns3/core-module.h"
-#include "ns3/network-module.h"
-#include "ns3/applications-module.h"
-#include "ns3/wifi-module.h"
-#include "ns3/mobility-module.h"
-#include "ns3/ipv4-global-routing-helper.h"
-#include "ns3/internet-module.h"
-#include <vector> 
+#include "tcp-80211b-experiment.h"
+#include <fstream>
 
 NS_LOG_COMPONENT_DEFINE ("tcp-80211b");
 
@@ -45,164 +79,168 @@ using namespace ns3;
 int
 main(int argc, char *argv[])
 {
-  double throughput = 0;
-  uint32_t totalPacketsThrough = 0;
-
-  uint32_t nWifi = 50;
-  uint32_t payloadSize = 1024;                       /* Transport layer payload size in bytes. */
-  std::string dataRate = "100Mbps";                  /* Application layer datarate. */
-  std::string tcpVariant = "ns3::TcpNewReno";        /* TCP variant type. */
-  std::string phyRate = "DsssRate11Mbps";            /* Physical layer bitrate. */
-  double simulationTime = 1;                         /* Simulation time in seconds. */
-  bool pcapTracing = false;                          /* PCAP Tracing is enabled or not. */
+  ExperimentConfig config;
+  bool checkReset = false;
+  std::string rateHistogram = "";
+  std::string replay = "";
+  std::string energyReport = "";
+  std::string topologyReport = "";
+  std::string memoryReport = "";
 
   /* Command line argument parser setup. */
   CommandLine cmd;
-  cmd.AddValue ("nWifi", "Number of STA nodes", nWifi);
-  cmd.AddValue ("payloadSize", "Payload size in bytes", payloadSize);
-  cmd.AddValue ("dataRate", "Application data rate", dataRate);
-  cmd.AddValue ("tcpVariant", "Transport protocol to use: TcpTahoe, TcpReno, TcpNewReno, TcpWestwood, TcpWestwoodPlus ", tcpVariant);
-  cmd.AddValue ("phyRate", "Physical layer bitrate: DsssRate11Mbps, DsssRate5_5Mbps, DsssRate2Mbps, DsssRate1Mbps ", phyRate);  
-  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
-  cmd.AddValue ("pcap", "Enable/disable PCAP Tracing", pcapTracing);
+  AddScenarioOptions (cmd, config);
+  cmd.AddValue ("rateHistogram", "File to write the per-station rate histogram to", rateHistogram);
+  cmd.AddValue ("checkReset", "Run twice with ResetExperiment () in between and compare", checkReset);
+  cmd.AddValue ("energyReport", "File to write the per-station airtime and energy to, with --energy", energyReport);
+  cmd.AddValue ("topologyReport", "File to write the STA positions and how many STAs each hears to, with a topology other than grid", topologyReport);
+  cmd.AddValue ("memoryReport", "File to write the bytes each subsystem keeps, in total and per STA, to", memoryReport);
+  cmd.AddValue ("replay", "Re-run the point a saved manifest describes and compare the results", replay);
+  AddEngineOptions (cmd, config);
   cmd.Parse (argc, argv);
+  config.countRates = config.countRates || rateHistogram != "";
 
-  /* No fragmentation */
-  Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("999999"));
+  /* A replay starts from the state every sweep point starts from, with the
+   * recorded configuration, attribute defaults and global values. */
+  ExperimentManifest recorded;
+  if (replay != "")
+    {
+      recorded = ExperimentManifest::Load (replay);
+      ReadManifestConfig (recorded, config);
+      ResetExperiment (config);
+      recorded.ApplyDefaults ();
+    }
+  else if (checkReset)
+    {
+      ResetExperiment (config);
+    }
+  ExperimentResult result = RunExperiment (config);
   
-  /* Disable RTS/CTS */
-  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("999999"));
-  /* Enable RTS/CTS for frames larger than 1000 */
-  //Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("1000"));
-
-
-  /* Configure TCP Options */
-  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (payloadSize));
-
-  WifiMacHelper wifiMac;
-  WifiHelper wifiHelper;
-  wifiHelper.SetStandard (WIFI_PHY_STANDARD_80211b);
-
-  /* Set up Legacy Channel */
-  YansWifiChannelHelper wifiChannel ;
-  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
-  wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (5e9));
-
-  /* Setup Physical Layer */
-  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
-  wifiPhy.SetChannel (wifiChannel.Create ());
-  wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
-  wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
-  wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
-  wifiPhy.Set ("TxGain", DoubleValue (0));
-  wifiPhy.Set ("RxGain", DoubleValue (0));
-  wifiPhy.Set ("RxNoiseFigure", DoubleValue (10));
-  wifiPhy.Set ("CcaMode1Threshold", DoubleValue (-79));
-  wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue (-79 + 3));
-  wifiPhy.SetErrorRateModel ("ns3::YansErrorRateModel");
-  wifiHelper.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
-                                      "DataMode", StringValue (phyRate),
-                                      "ControlMode", StringValue (phyRate));
-
-  NodeContainer wifiStaNodes;
-  wifiStaNodes.Create (nWifi);
-  NodeContainer wifiApNode;
-  wifiApNode.Create (1);
-
-  /* Configure AP */
-  Ssid ssid = Ssid ("network");
-  wifiMac.SetType ("ns3::ApWifiMac",
-                    "Ssid", SsidValue (ssid));
-
-  NetDeviceContainer apDevice;
-  apDevice = wifiHelper.Install (wifiPhy, wifiMac, wifiApNode);
-
-  /* Configure STA */
-  wifiMac.SetType ("ns3::StaWifiMac",
-                    "Ssid", SsidValue (ssid),
-                    "ActiveProbing", BooleanValue (false));
-
-  NetDeviceContainer staDevices;
-  staDevices = wifiHelper.Install (wifiPhy, wifiMac, wifiStaNodes);
-
-  /* Mobility model */
-  MobilityHelper mobility;
-
-  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
-                                 "MinX", DoubleValue (0.0),
-                                 "MinY", DoubleValue (0.0),
-                                 "DeltaX", DoubleValue (5.0),
-                                 "DeltaY", DoubleValue (10.0),
-                                 "GridWidth", UintegerValue (3),
-                                 "LayoutType", StringValue ("RowFirst"));
-
-  mobility.SetMobilityModel("ns3::RandomDirection2dMobilityModel",
-                              "Bounds", RectangleValue(Rectangle(-500, 500, -500, 500)),
-                              "Speed", StringValue ("ns3::ConstantRandomVariable[Constant=2]"),
-                              "Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
-
-  mobility.Install (wifiStaNodes);
-
-  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
-  mobility.Install (wifiApNode);
-
-
-  /* Internet stack */
-  InternetStackHelper stack;
-  stack.Install (wifiApNode);
-  stack.Install (wifiStaNodes);
-
-  Ipv4AddressHelper address;
-
-  address.SetBase ("192.168.1.0", "255.255.255.0");
-  Ipv4InterfaceContainer StaInterface;
-  StaInterface = address.Assign (staDevices);
-  Ipv4InterfaceContainer ApInterface;
-  ApInterface = address.Assign (apDevice);
-
-  /* Populate routing table */
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
-
-  /* Install TCP Receiver on the access point */
-  uint16_t port = 50000;
-  Address apLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
-  PacketSinkHelper packetSinkHelper ("ns3::TcpSocketFactory", apLocalAddress);
-      
-  ApplicationContainer sinkApp = packetSinkHelper.Install (wifiApNode.Get (0));
-  sinkApp.Start (Seconds (0.0));
-  sinkApp.Stop (Seconds (simulationTime + 1));
-
-  /* Install TCP Transmitter on the stations */
-  OnOffHelper onoff ("ns3::TcpSocketFactory",Ipv4Address::GetAny ());
-  onoff.SetAttribute ("OnTime",  StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-  onoff.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
-  onoff.SetAttribute ("PacketSize", UintegerValue (payloadSize));
-  onoff.SetAttribute ("DataRate", DataRateValue (DataRate (dataRate)));
-      
-  AddressValue remoteAddress (InetSocketAddress (ApInterface.GetAddress (0), port));
-  onoff.SetAttribute ("Remote", remoteAddress);
-      
-  ApplicationContainer apps;
-  apps.Add (onoff.Install (wifiStaNodes));
-  apps.Start (Seconds (1.0));
-  apps.Stop (Seconds (simulationTime + 1));
-
-  /* Enable Traces */
-  if (pcapTracing)
+  std::cout << "\nThroughtput: " << result.throughput << " Mbit/s" << std::endl;
+  if (config.lazyStations)
+    {
+      std::cout << "Active STAs: " << result.activeStations << " of " << config.nWifi << std::endl;
+    }
+  if (config.topology != "grid")
+    {
+      std::cout << "Topology: " << config.topology << " of radius " << result.topology.GetRadius () << " m, hearing range "
+                << result.topology.GetHearingRange () << " m, decode range " << result.topology.GetDecodeRange () << " m, "
+                << result.topology.GetHiddenFraction () * 100
+                << "% hidden STA pairs, " << result.topology.GetMeanNeighbours () << " STAs heard per STA, "
+                << result.topology.GetOutOfRange () << " STAs out of range of the AP" << std::endl;
+      if (topologyReport != "")
+        {
+          std::ofstream topologyFile (topologyReport.c_str ());
+          result.topology.Write (topologyFile);
+        }
+    }
+  if (config.trace != "")
+    {
+      std::cout << "Trace: " << result.traceRecords << " packets replayed, " << result.traceSkipped
+                << " of stations beyond nWifi skipped" << std::endl;
+    }
+  if (config.countRates)
+    {
+      std::map<std::string, uint64_t> rates = result.rates.GetTotal ();
+      std::cout << "Data frames per rate:";
+      for (std::map<std::string, uint64_t>::const_iterator i = rates.begin (); i != rates.end (); ++i)
+        {
+          std::cout << " " << i->first << "=" << i->second;
+        }
+      std::cout << std::endl;
+    }
+  for (uint32_t i = 0; i < result.rateMix.GetNClasses (); i++)
+    {
+      const RateClass &rateClass = result.rateMix.GetClass (i);
+      std::cout << "Rate class " << rateClass.mode << ": " << rateClass.stations << " STAs, "
+                << rateClass.rxBytes * 8 / (config.simulationTime * 1000000.0) << " Mbit/s" << std::endl;
+    }
+  if (rateHistogram != "")
+    {
+      std::ofstream histogramFile (rateHistogram.c_str ());
+      result.rates.Write (histogramFile);
+    }
+  if (config.countFrames)
     {
-      wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11_RADIO);
-      wifiPhy.EnablePcap ("AccessPoint", apDevice);
-      wifiPhy.EnablePcap ("Station", staDevices);
+      std::cout << "RTS/CTS: " << result.frames.rtsFrames << " RTS, " << result.frames.ctsFrames << " CTS, "
+                << result.rtsCtsOverhead * 100 << "% of the airtime" << std::endl;
+      std::cout << "Collisions: " << result.frames.rtsFailed << " RTS failed, " << result.frames.dataFailed
+                << " data frames failed, " << result.frames.rxDrops << " receptions dropped" << std::endl;
+      std::cout << "Fragments: " << result.frames.ipFragments << " IP (" << result.frames.ipReassemblyTimeouts
+                << " reassembly timeouts), " << result.frames.macFragments << " MAC" << std::endl;
     }
+  std::cout << "Setup: " << result.setupTime << " s, run: " << result.wallTime << " s" << std::endl;
+  std::cout << "Scheduler: " << result.scheduler
+            << ", events: " << result.events
+            << " (" << result.events / result.wallTime << " events/s)"
+            << ", peak event set size: " << result.peakEventSetSize << std::endl;
+  std::cout << "Allocations: " << result.allocations << ", malloc calls: " << result.mallocCalls << std::endl;
+  double stations = std::max (result.activeStations, 1u);
+  std::cout << "Memory: " << result.memory.GetTotal () / stations << " bytes per STA (";
+  for (uint32_t i = 0; i < result.memory.GetNSubsystems (); i++)
+    {
+      std::cout << (i > 0 ? ", " : "") << result.memory.GetName (i) << " " << result.memory.GetBytes (i) / stations;
+    }
+  std::cout << ")" << std::endl;
+  if (memoryReport != "")
+    {
+      std::ofstream memoryFile (memoryReport.c_str ());
+      result.memory.Write (memoryFile, result.activeStations);
+    }
+  if (config.energy)
+    {
+      StationAirtime total = result.energy.GetTotal ();
+      std::cout << "Energy: " << total.energy << " J over " << result.energy.GetNStations () << " STAs, "
+                << result.energy.GetJoulesPerBit () * 1e9 << " nJ per delivered bit" << std::endl;
+      std::cout << "STA airtime: " << total.tx << " s TX, " << total.rx << " s RX, " << total.idle << " s idle, "
+                << total.ccaBusy << " s CCA busy" << std::endl;
+      if (energyReport != "")
+        {
+          std::ofstream energyFile (energyReport.c_str ());
+          result.energy.Write (energyFile);
+        }
+    }
+  if (config.seriesInterval > 0)
+    {
+      std::cout << "Series: " << result.series.GetNBins () << " bins of " << result.series.GetInterval () * 1000
+                << " ms, " << result.series.GetEmptyBins () << " with nothing received";
+      if (result.seriesFile != "")
+        {
+          std::cout << ", saved to " << result.seriesFile;
+        }
+      std::cout << std::endl;
+    }
+  std::cout << "Manifest: " << result.manifest.GetHash () << std::endl;
 
-  /* Start Simulation */
-  Simulator::Stop (Seconds (simulationTime + 1));
-  Simulator::Run ();
-  Simulator::Destroy ();
+  if (replay != "")
+    {
+      /* A different build may still reproduce the point, anything else may not. */
+      std::vector<std::string> differences = recorded.Compare (result.manifest);
+      uint32_t mismatches = 0;
+      for (std::vector<std::string>::const_iterator i = differences.begin (); i != differences.end (); ++i)
+        {
+          std::cout << (i->compare (0, 6, "build.") == 0 ? "Replay warning: " : "Replay mismatch: ") << *i
+                    << " recorded '" << recorded.Get (*i) << "', now '" << result.manifest.Get (*i) << "'" << std::endl;
+          mismatches += i->compare (0, 6, "build.") != 0;
+        }
+      NS_ABORT_MSG_IF (mismatches > 0, "Replay of " << replay << " did not reproduce the recorded point");
+      std::cout << "Replay passed: " << replay << " reproduced (" << result.totalRx << " bytes)" << std::endl;
+    }
 
-  totalPacketsThrough = DynamicCast<PacketSink> (sinkApp.Get (0))->GetTotalRx ();
-  throughput = totalPacketsThrough * 8 / (simulationTime * 1000000.0);
-  
-  std::cout << "\nThroughtput: " << throughput << " Mbit/s" << std::endl;
+  if (checkReset)
+    {
+      ResetExperiment (config);
+      ExperimentResult again = RunExperiment (config);
+      /* The configuration, attributes and every result.* entry. */
+      std::vector<std::string> differences = result.manifest.Compare (again.manifest);
+      for (std::vector<std::string>::const_iterator i = differences.begin (); i != differences.end (); ++i)
+        {
+          std::cout << "Reset mismatch: " << *i << " first '" << result.manifest.Get (*i)
+                    << "', second '" << again.manifest.Get (*i) << "'" << std::endl;
+        }
+      NS_ABORT_MSG_UNLESS (differences.empty (), "Second run after ResetExperiment () differs");
+      std::cout << "Reset check passed: second run identical (" << again.wallTime << " s vs "
+                << result.wallTime << " s in Simulator::Run ())" << std::endl;
+    }
   return 0;
 }
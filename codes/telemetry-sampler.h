@@ -0,0 +1,250 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Periodic in-simulation sampler that publishes the progress of a run as
+ * JSON Lines, one object per sample: simulated and wall-clock time, their
+ * ratio, bytes received by the sink, events executed and pending, and the
+ * depth of the wifi MAC queues. Its own events are not counted (see
+ * CountingScheduler), so telemetry does not change the events a run reports.
+ *
+ * The target is either a file, which is appended to (tail -f it), or
+ * unix:<path>, a Unix stream socket someone listens on, e.g.
+ *   socat UNIX-LISTEN:/tmp/tcp-80211b.sock,fork -
+ * If nobody listens the samples are dropped, the run carries on. The socket
+ * is written without blocking: while a listener does not read, the line it
+ * has not taken yet is kept and the samples after it are dropped and
+ * counted (droppedSamples), so a stalled listener never stalls the run.
+ */
+
+#ifndef TELEMETRY_SAMPLER_H
+#define TELEMETRY_SAMPLER_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/wifi-module.h"
+#include "counting-scheduler.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+class TelemetrySampler
+{
+public:
+  TelemetrySampler ();
+  ~TelemetrySampler ();
+
+  /* Open the target, a file name or unix:<path>. label is a JSON fragment
+   * identifying the run, added to every sample. */
+  void Open (const std::string &target, const std::string &label);
+  /* Sample every interval of simulated time from now on. */
+  void Start (Time interval, Ptr<PacketSink> sink, NetDeviceContainer devices);
+  /* Write a last sample, marked final, once Simulator::Run () returned. */
+  void Finish (void);
+
+private:
+  void Sample (void);
+  void Write (bool final);
+  void Publish (const std::string &line);
+  /* Send what the socket takes of m_pending, false once the socket closed. */
+  bool Flush (void);
+
+  std::string m_label;
+  std::ofstream m_file;
+  int m_socket;
+  std::string m_pending;                             /* Rest of a line the socket did not take yet. */
+  uint64_t m_dropped;                                /* Samples dropped while the listener did not read. */
+  Time m_interval;
+  Ptr<PacketSink> m_sink;
+  std::vector<Ptr<WifiMacQueue> > m_queues;
+  std::chrono::steady_clock::time_point m_wallStart;
+  double m_lastWall;
+  double m_lastSim;
+  uint64_t m_lastRx;
+  uint64_t m_lastEvents;
+};
+
+TelemetrySampler::TelemetrySampler ()
+  : m_socket (-1),
+    m_dropped (0),
+    m_lastWall (0),
+    m_lastSim (0),
+    m_lastRx (0),
+    m_lastEvents (0)
+{
+}
+
+TelemetrySampler::~TelemetrySampler ()
+{
+  if (m_socket >= 0)
+    {
+      close (m_socket);
+    }
+}
+
+void
+TelemetrySampler::Open (const std::string &target, const std::string &label)
+{
+  m_label = label;
+  if (target.compare (0, 5, "unix:") == 0)
+    {
+      std::string path = target.substr (5);
+      struct sockaddr_un addr;
+      std::memset (&addr, 0, sizeof (addr));
+      addr.sun_family = AF_UNIX;
+      NS_ABORT_MSG_IF (path.size () >= sizeof (addr.sun_path), "Telemetry socket path too long: " << path);
+      std::strncpy (addr.sun_path, path.c_str (), sizeof (addr.sun_path) - 1);
+      m_socket = socket (AF_UNIX, SOCK_STREAM, 0);
+      if (m_socket >= 0 && connect (m_socket, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+        {
+          std::cerr << "Telemetry: nobody listens on " << path << ", samples are dropped" << std::endl;
+          close (m_socket);
+          m_socket = -1;
+        }
+    }
+  else
+    {
+      m_file.open (target.c_str (), std::ios::app);
+      NS_ABORT_MSG_UNLESS (m_file.is_open (), "Cannot open telemetry file " << target);
+    }
+}
+
+void
+TelemetrySampler::Start (Time interval, Ptr<PacketSink> sink, NetDeviceContainer devices)
+{
+  m_interval = interval;
+  m_sink = sink;
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+    {
+      Ptr<RegularWifiMac> mac = DynamicCast<RegularWifiMac> (DynamicCast<WifiNetDevice> (*i)->GetMac ());
+      PointerValue dcaTxop;
+      mac->GetAttribute ("DcaTxop", dcaTxop);
+      m_queues.push_back (dcaTxop.Get<DcaTxop> ()->GetQueue ());
+    }
+  m_wallStart = std::chrono::steady_clock::now ();
+  m_lastSim = Simulator::Now ().GetSeconds ();
+  CountingScheduler::ScheduleUncounted (m_interval, &TelemetrySampler::Sample, this);
+}
+
+void
+TelemetrySampler::Finish (void)
+{
+  Write (true);
+}
+
+void
+TelemetrySampler::Sample (void)
+{
+  Write (false);
+  CountingScheduler::ScheduleUncounted (m_interval, &TelemetrySampler::Sample, this);
+}
+
+void
+TelemetrySampler::Write (bool final)
+{
+  double wall = std::chrono::duration<double> (std::chrono::steady_clock::now () - m_wallStart).count ();
+  double sim = Simulator::Now ().GetSeconds ();
+  uint64_t rx = m_sink->GetTotalRx ();
+  CountingScheduler *scheduler = CountingScheduler::GetCurrent ();
+  uint64_t events = scheduler ? scheduler->GetExecuted () : 0;
+  uint64_t pending = scheduler ? scheduler->GetSize () : 0;
+  uint64_t queued = 0;
+  uint32_t maxQueue = 0;
+  for (std::vector<Ptr<WifiMacQueue> >::const_iterator i = m_queues.begin (); i != m_queues.end (); ++i)
+    {
+      uint32_t depth = (*i)->GetNPackets ();
+      queued += depth;
+      maxQueue = std::max (maxQueue, depth);
+    }
+  double dWall = wall - m_lastWall;
+  double dSim = sim - m_lastSim;
+
+  std::ostringstream line;
+  line << "{" << m_label
+       << "\"simTime\":" << sim
+       << ",\"wallTime\":" << wall
+       << ",\"simPerWall\":" << (dWall > 0 ? dSim / dWall : 0)
+       << ",\"sinkBytes\":" << rx
+       << ",\"throughputMbps\":" << (dSim > 0 ? (rx - m_lastRx) * 8 / (dSim * 1000000.0) : 0)
+       << ",\"events\":" << events
+       << ",\"eventsPerSecond\":" << (dWall > 0 ? (events - m_lastEvents) / dWall : 0)
+       << ",\"pendingEvents\":" << pending
+       << ",\"queuedPackets\":" << queued
+       << ",\"maxQueue\":" << maxQueue
+       << ",\"droppedSamples\":" << m_dropped;
+  if (final)
+    {
+      line << ",\"final\":true";
+    }
+  line << "}\n";
+  Publish (line.str ());
+
+  m_lastWall = wall;
+  m_lastSim = sim;
+  m_lastRx = rx;
+  m_lastEvents = events;
+}
+
+void
+TelemetrySampler::Publish (const std::string &line)
+{
+  if (m_file.is_open ())
+    {
+      m_file << line;
+      m_file.flush ();
+    }
+  else if (m_socket >= 0)
+    {
+      if (!Flush ())
+        {
+          return;
+        }
+      if (!m_pending.empty ())
+        {
+          m_dropped++;
+          return;
+        }
+      m_pending = line;
+      Flush ();
+    }
+}
+
+bool
+TelemetrySampler::Flush (void)
+{
+  while (!m_pending.empty ())
+    {
+      ssize_t sent = send (m_socket, m_pending.data (), m_pending.size (), MSG_NOSIGNAL | MSG_DONTWAIT);
+      if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+          return true;
+        }
+      if (sent < 0 && errno == EINTR)
+        {
+          continue;
+        }
+      if (sent <= 0)
+        {
+          close (m_socket);
+          m_socket = -1;
+          return false;
+        }
+      m_pending.erase (0, sent);
+    }
+  return true;
+}
+
+} // namespace ns3
+
+#endif /* TELEMETRY_SAMPLER_H */
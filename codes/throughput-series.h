@@ -0,0 +1,220 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Throughput of a run over time instead of a single number: one event per
+ * bin reads PacketSink::GetTotalRx () and keeps the bytes received since
+ * the previous one. Per STA series, if asked for, come from the sink's Rx
+ * trace (once per packet); station i is the one at address network + i + 1,
+ * which is where the eager and the lazy scenario both put it.
+ *
+ * A run that starves and recovers then shows as the bins it starved in,
+ * which the throughput of the whole run averages away. When the interval
+ * does not divide the run, the last bin is shorter and ends at the stop
+ * time. The bin events are not counted (see CountingScheduler), so the
+ * series does not change the events a run reports.
+ */
+
+#ifndef THROUGHPUT_SERIES_H
+#define THROUGHPUT_SERIES_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include "counting-scheduler.h"
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+
+class ThroughputSeries
+{
+public:
+  ThroughputSeries ();
+
+  /* Bins of interval from start to stop. With perStation, also the bytes
+   * from each of nStations STAs numbered from network. */
+  void Install (Ptr<PacketSink> sink, Time interval, Time start, Time stop,
+                bool perStation, Ipv4Address network, uint32_t nStations);
+  /* Take the bin that ends at the stop time, which Simulator::Stop ()
+   * cuts off, whole or partial, and let go of the sink, once
+   * Simulator::Run () returned. */
+  void Finish (void);
+
+  uint32_t GetNBins (void) const;
+  double GetInterval (void) const;
+  /* Mbit/s of the whole cell and of one STA in bin i, over its length. */
+  double GetThroughput (uint32_t bin) const;
+  double GetStationThroughput (uint32_t bin, uint32_t station) const;
+  /* Bins the sink received nothing in. */
+  uint32_t GetEmptyBins (void) const;
+
+  /* A time (end of the bin), throughput[, sta0, sta1, ...] line per bin. */
+  void Write (std::ostream &os) const;
+
+private:
+  void Sample (void);
+  void Record (void);
+  void Rx (Ptr<const Packet> packet, const Address &from);
+  /* Where bin i ends, and its length in seconds. */
+  Time GetBinEnd (uint32_t bin) const;
+  double GetBinLength (uint32_t bin) const;
+
+  Ptr<PacketSink> m_sink;
+  Time m_interval;
+  Time m_start;
+  Time m_stop;
+  Time m_next;                                       /* End of the bin under way. */
+  Time m_end;                                        /* End of the last bin taken. */
+  uint64_t m_lastTotal;
+  std::vector<uint64_t> m_bins;                      /* Bytes per bin. */
+  bool m_perStation;
+  uint32_t m_network;
+  std::vector<uint32_t> m_current;                   /* Bytes per STA in the bin under way. */
+  std::vector<std::vector<uint32_t> > m_stationBins; /* Bytes per bin and STA. */
+};
+
+ThroughputSeries::ThroughputSeries ()
+  : m_lastTotal (0),
+    m_perStation (false),
+    m_network (0)
+{
+}
+
+void
+ThroughputSeries::Install (Ptr<PacketSink> sink, Time interval, Time start, Time stop,
+                           bool perStation, Ipv4Address network, uint32_t nStations)
+{
+  NS_ABORT_MSG_UNLESS (interval.IsStrictlyPositive (), "The series interval must be positive");
+  m_sink = sink;
+  m_interval = interval;
+  m_start = start;
+  m_stop = stop;
+  m_perStation = perStation;
+  m_next = start + interval;
+  if (perStation)
+    {
+      m_network = network.Get ();
+      m_current.assign (nStations, 0);
+      sink->TraceConnectWithoutContext ("Rx", MakeCallback (&ThroughputSeries::Rx, this));
+    }
+  CountingScheduler::ScheduleUncounted (m_next, &ThroughputSeries::Sample, this);
+}
+
+void
+ThroughputSeries::Finish (void)
+{
+  if (m_sink != 0 && Simulator::Now () > m_next - m_interval)
+    {
+      Record ();
+    }
+  m_sink = 0;
+}
+
+void
+ThroughputSeries::Sample (void)
+{
+  Record ();
+  if (m_next < m_stop)
+    {
+      CountingScheduler::ScheduleUncounted (m_next - Simulator::Now (), &ThroughputSeries::Sample, this);
+    }
+}
+
+void
+ThroughputSeries::Record (void)
+{
+  uint64_t total = m_sink->GetTotalRx ();
+  m_bins.push_back (total - m_lastTotal);
+  m_lastTotal = total;
+  if (m_perStation)
+    {
+      m_stationBins.push_back (m_current);
+      std::fill (m_current.begin (), m_current.end (), 0);
+    }
+  m_end = Simulator::Now ();
+  m_next += m_interval;
+}
+
+void
+ThroughputSeries::Rx (Ptr<const Packet> packet, const Address &from)
+{
+  uint32_t station = InetSocketAddress::ConvertFrom (from).GetIpv4 ().Get () - m_network - 1;
+  if (station < m_current.size ())
+    {
+      m_current[station] += packet->GetSize ();
+    }
+}
+
+uint32_t
+ThroughputSeries::GetNBins (void) const
+{
+  return m_bins.size ();
+}
+
+double
+ThroughputSeries::GetInterval (void) const
+{
+  return m_interval.GetSeconds ();
+}
+
+double
+ThroughputSeries::GetThroughput (uint32_t bin) const
+{
+  return m_bins[bin] * 8 / (GetBinLength (bin) * 1000000.0);
+}
+
+double
+ThroughputSeries::GetStationThroughput (uint32_t bin, uint32_t station) const
+{
+  return m_stationBins[bin][station] * 8 / (GetBinLength (bin) * 1000000.0);
+}
+
+Time
+ThroughputSeries::GetBinEnd (uint32_t bin) const
+{
+  return std::min (m_start + TimeStep (m_interval.GetTimeStep () * (bin + 1)), m_end);
+}
+
+double
+ThroughputSeries::GetBinLength (uint32_t bin) const
+{
+  return (GetBinEnd (bin) - m_start - TimeStep (m_interval.GetTimeStep () * bin)).GetSeconds ();
+}
+
+uint32_t
+ThroughputSeries::GetEmptyBins (void) const
+{
+  uint32_t empty = 0;
+  for (uint32_t i = 0; i < m_bins.size (); i++)
+    {
+      empty += m_bins[i] == 0;
+    }
+  return empty;
+}
+
+void
+ThroughputSeries::Write (std::ostream &os) const
+{
+  os << "time" << "\t" << "throughput";
+  for (uint32_t station = 0; m_perStation && station < m_current.size (); station++)
+    {
+      os << "\t" << "sta" << station;
+    }
+  os << std::endl;
+  for (uint32_t bin = 0; bin < m_bins.size (); bin++)
+    {
+      os << GetBinEnd (bin).GetSeconds () << "\t" << GetThroughput (bin);
+      for (uint32_t station = 0; m_perStation && station < m_current.size (); station++)
+        {
+          os << "\t" << GetStationThroughput (bin, station);
+        }
+      os << std::endl;
+    }
+}
+
+} // namespace ns3
+
+#endif /* THROUGHPUT_SERIES_H */
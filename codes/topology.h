@@ -0,0 +1,305 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * STA placements that produce hidden terminals. The AP is at the origin and
+ * the STAs, which do not move, are placed
+ * - disk: uniformly in a disk of the given radius,
+ * - ring: evenly on a circle of the given radius,
+ * - cluster: uniformly in small disks (a quarter of the radius) centred
+ *   evenly on a circle of the given radius.
+ * Two STAs hear each other when the loss model puts the frames of one above
+ * the CCA threshold at the other, that is within the hearing range. A pair
+ * that does not is hidden: neither defers to the other. A STA reaches the
+ * AP only within the shorter decode range, where its frames are above the
+ * energy detection threshold the PHY starts receiving at.
+ *
+ * With a target hidden pair fraction the radius is found by bisection: the
+ * layout is drawn once for radius 1 and scaled, so the fraction only grows
+ * with the radius, and we take the largest radius that hides at most the
+ * target. The radius is capped so that every STA still reaches the AP: a
+ * layout that cannot hide that many pairs hides as many as it can, which
+ * GetHiddenFraction () reports.
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include <cmath>
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+
+class Topology
+{
+public:
+  Topology ();
+
+  /* Place nStations with the layout. hiddenFraction < 0 keeps the radius,
+   * otherwise the radius is chosen to hide that share of the STA pairs.
+   * ccaThresholdDbm decides which STAs hear each other, detectionThresholdDbm
+   * which STAs reach the AP. */
+  void Generate (const std::string &layout, uint32_t nStations, double radius, double hiddenFraction, uint32_t clusters,
+                 Ptr<PropagationLossModel> loss, double txPowerDbm, double ccaThresholdDbm, double detectionThresholdDbm);
+
+  /* ConstantPositionMobilityModels at the generated positions. */
+  void Install (NodeContainer stations, NodeContainer ap) const;
+
+  double GetRadius (void) const;
+  double GetHearingRange (void) const;
+  double GetDecodeRange (void) const;
+  /* Share of the STA pairs that do not hear each other. */
+  double GetHiddenFraction (void) const;
+  /* STAs the average STA hears. */
+  double GetMeanNeighbours (void) const;
+  /* STAs beyond the decode range of the AP. */
+  uint32_t GetOutOfRange (void) const;
+
+  /* One station, x, y, neighbours, hidden line per STA. */
+  void Write (std::ostream &os) const;
+
+private:
+  /* The distance at which the loss reaches thresholdDbm. */
+  static double GetRange (Ptr<PropagationLossModel> loss, double txPowerDbm, double thresholdDbm);
+  double GetHiddenFraction (double radius) const;
+
+  std::vector<Vector> m_unit;                        /* The layout for radius 1. */
+  double m_radius;
+  double m_hearingRange;
+  double m_decodeRange;
+  double m_hiddenFraction;
+  std::vector<uint32_t> m_neighbours;
+};
+
+/* Squared distance in the plane. */
+inline double
+GetDistanceSquared (const Vector &a, const Vector &b)
+{
+  return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+}
+
+Topology::Topology ()
+  : m_radius (0),
+    m_hearingRange (0),
+    m_decodeRange (0),
+    m_hiddenFraction (0)
+{
+}
+
+void
+Topology::Generate (const std::string &layout, uint32_t nStations, double radius, double hiddenFraction, uint32_t clusters,
+                    Ptr<PropagationLossModel> loss, double txPowerDbm, double ccaThresholdDbm, double detectionThresholdDbm)
+{
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  m_unit.clear ();
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      if (layout == "disk")
+        {
+          double r = std::sqrt (uniform->GetValue (0, 1));
+          double angle = uniform->GetValue (0, 2 * M_PI);
+          m_unit.push_back (Vector (r * std::cos (angle), r * std::sin (angle), 0));
+        }
+      else if (layout == "ring")
+        {
+          double angle = 2 * M_PI * i / nStations;
+          m_unit.push_back (Vector (std::cos (angle), std::sin (angle), 0));
+        }
+      else if (layout == "cluster")
+        {
+          NS_ABORT_MSG_IF (clusters == 0, "clusters must be at least 1");
+          double center = 2 * M_PI * (i % clusters) / clusters;
+          double r = 0.25 * std::sqrt (uniform->GetValue (0, 1));
+          double angle = uniform->GetValue (0, 2 * M_PI);
+          m_unit.push_back (Vector (std::cos (center) + r * std::cos (angle), std::sin (center) + r * std::sin (angle), 0));
+        }
+      else
+        {
+          NS_FATAL_ERROR ("Unknown topology " << layout << ", use grid, disk, ring or cluster");
+        }
+    }
+
+  m_hearingRange = GetRange (loss, txPowerDbm, ccaThresholdDbm);
+  m_decodeRange = GetRange (loss, txPowerDbm, detectionThresholdDbm);
+
+  if (hiddenFraction < 0)
+    {
+      NS_ABORT_MSG_UNLESS (radius > 0, "radius must be positive");
+      m_radius = radius;
+    }
+  else
+    {
+      /* The largest radius at which every STA still reaches the AP. */
+      double extent = 0;
+      for (uint32_t i = 0; i < nStations; i++)
+        {
+          extent = std::max (extent, std::sqrt (m_unit[i].x * m_unit[i].x + m_unit[i].y * m_unit[i].y));
+        }
+      double low = 0;
+      double high = extent > 0 ? m_decodeRange / extent : m_decodeRange;
+      for (uint32_t i = 0; i < 50; i++)
+        {
+          double middle = (low + high) / 2;
+          if (GetHiddenFraction (middle) <= hiddenFraction)
+            {
+              low = middle;
+            }
+          else
+            {
+              high = middle;
+            }
+        }
+      m_radius = low;
+    }
+  m_hiddenFraction = GetHiddenFraction (m_radius);
+
+  double range = m_hearingRange / m_radius;
+  m_neighbours.assign (nStations, 0);
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      for (uint32_t j = i + 1; j < nStations; j++)
+        {
+          if (GetDistanceSquared (m_unit[i], m_unit[j]) <= range * range)
+            {
+              m_neighbours[i]++;
+              m_neighbours[j]++;
+            }
+        }
+    }
+}
+
+double
+Topology::GetRange (Ptr<PropagationLossModel> loss, double txPowerDbm, double thresholdDbm)
+{
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  double near = 0;
+  double far = 1;
+  b->SetPosition (Vector (far, 0, 0));
+  while (loss->CalcRxPower (txPowerDbm, a, b) >= thresholdDbm)
+    {
+      far *= 2;
+      NS_ABORT_MSG_IF (far > 1e7, "The loss model never reaches " << thresholdDbm << " dBm");
+      b->SetPosition (Vector (far, 0, 0));
+    }
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      double middle = (near + far) / 2;
+      b->SetPosition (Vector (middle, 0, 0));
+      if (loss->CalcRxPower (txPowerDbm, a, b) >= thresholdDbm)
+        {
+          near = middle;
+        }
+      else
+        {
+          far = middle;
+        }
+    }
+  return near;
+}
+
+double
+Topology::GetHiddenFraction (double radius) const
+{
+  uint32_t n = m_unit.size ();
+  if (n < 2 || radius <= 0)
+    {
+      return 0;
+    }
+  /* Compare squared distances at radius 1. */
+  double range = m_hearingRange / radius;
+  uint64_t hidden = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = i + 1; j < n; j++)
+        {
+          hidden += GetDistanceSquared (m_unit[i], m_unit[j]) > range * range;
+        }
+    }
+  return (double) hidden / (n * (n - 1.0) / 2);
+}
+
+void
+Topology::Install (NodeContainer stations, NodeContainer ap) const
+{
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < m_unit.size (); i++)
+    {
+      positions->Add (Vector (m_radius * m_unit[i].x, m_radius * m_unit[i].y, 0));
+    }
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (stations);
+
+  Ptr<ListPositionAllocator> origin = CreateObject<ListPositionAllocator> ();
+  origin->Add (Vector (0, 0, 0));
+  mobility.SetPositionAllocator (origin);
+  mobility.Install (ap);
+}
+
+double
+Topology::GetRadius (void) const
+{
+  return m_radius;
+}
+
+double
+Topology::GetHearingRange (void) const
+{
+  return m_hearingRange;
+}
+
+double
+Topology::GetDecodeRange (void) const
+{
+  return m_decodeRange;
+}
+
+double
+Topology::GetHiddenFraction (void) const
+{
+  return m_hiddenFraction;
+}
+
+double
+Topology::GetMeanNeighbours (void) const
+{
+  double neighbours = 0;
+  for (uint32_t i = 0; i < m_neighbours.size (); i++)
+    {
+      neighbours += m_neighbours[i];
+    }
+  return m_neighbours.empty () ? 0 : neighbours / m_neighbours.size ();
+}
+
+uint32_t
+Topology::GetOutOfRange (void) const
+{
+  uint32_t outOfRange = 0;
+  for (uint32_t i = 0; i < m_unit.size (); i++)
+    {
+      outOfRange += m_radius * std::sqrt (m_unit[i].x * m_unit[i].x + m_unit[i].y * m_unit[i].y) > m_decodeRange;
+    }
+  return outOfRange;
+}
+
+void
+Topology::Write (std::ostream &os) const
+{
+  os << "station" << "\t" << "x" << "\t" << "y" << "\t" << "neighbours" << "\t" << "hidden" << std::endl;
+  for (uint32_t i = 0; i < m_unit.size (); i++)
+    {
+      os << i << "\t" << m_radius * m_unit[i].x << "\t" << m_radius * m_unit[i].y << "\t" << m_neighbours[i]
+         << "\t" << m_unit.size () - 1 - m_neighbours[i] << std::endl;
+    }
+}
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_H */
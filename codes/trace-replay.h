@@ -0,0 +1,496 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * Trace driven traffic: every STA sends the packets a trace lists for it,
+ * at the times it lists, over a TCP connection to the access point's sink.
+ *
+ * A trace is a list of (time, station, size) records in time order, either
+ *   - CSV (file name ending in .csv): one "time,station,size" line per
+ *     packet, time in seconds; lines not starting with a digit are skipped,
+ *   - binary: the 8 byte magic "WTRACE1\0" followed by 16 byte little endian
+ *     records, uint64 time in nanoseconds, uint32 station, uint32 size
+ *     (traceConvert turns a CSV trace into one).
+ * Times are relative to the start of the applications. Records of stations
+ * beyond nWifi are skipped.
+ *
+ * With InstallLazy () a station is only built, through a callback, when its
+ * first record is due; its application connects once it associated.
+ *
+ * The file is memory mapped and read one record ahead: a single event is
+ * pending for the whole trace, and pages already replayed can be dropped by
+ * the kernel, so traces much larger than RAM replay fine.
+ */
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/wifi-module.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+static const char TRACE_MAGIC[8] = { 'W', 'T', 'R', 'A', 'C', 'E', '1', '\0' };
+
+struct TraceRecord
+{
+  uint64_t time;                                     /* Nanoseconds after the start of the applications. */
+  uint32_t station;
+  uint32_t size;                                     /* Bytes. */
+};
+
+/* Bytes of a binary record in the file. */
+static const uint32_t TRACE_RECORD_SIZE = 16;
+
+/* Little endian value of the bytes at data, whatever the host byte order. */
+inline uint64_t
+ReadLittleEndian (const unsigned char *data, uint32_t bytes)
+{
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < bytes; i++)
+    {
+      value |= (uint64_t) data[i] << (8 * i);
+    }
+  return value;
+}
+
+inline void
+WriteLittleEndian (unsigned char *data, uint64_t value, uint32_t bytes)
+{
+  for (uint32_t i = 0; i < bytes; i++)
+    {
+      data[i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
+/* A record from and to its TRACE_RECORD_SIZE bytes in the file. */
+inline TraceRecord
+DecodeTraceRecord (const unsigned char *data)
+{
+  TraceRecord record;
+  record.time = ReadLittleEndian (data, 8);
+  record.station = ReadLittleEndian (data + 8, 4);
+  record.size = ReadLittleEndian (data + 12, 4);
+  return record;
+}
+
+inline void
+EncodeTraceRecord (const TraceRecord &record, unsigned char *data)
+{
+  WriteLittleEndian (data, record.time, 8);
+  WriteLittleEndian (data + 8, record.station, 4);
+  WriteLittleEndian (data + 12, record.size, 4);
+}
+
+/* Sequential reader over a memory mapped trace. */
+class TraceReader
+{
+public:
+  TraceReader ();
+  ~TraceReader ();
+
+  void Open (const std::string &fileName);
+  /* The next record, false at the end of the trace. */
+  bool Next (TraceRecord &record);
+
+private:
+  TraceReader (const TraceReader &);
+  TraceReader & operator = (const TraceReader &);
+
+  bool NextCsv (TraceRecord &record);
+
+  std::string m_fileName;
+  const char *m_data;
+  size_t m_size;
+  size_t m_offset;
+  bool m_csv;
+  uint64_t m_line;
+  uint64_t m_lastTime;
+};
+
+TraceReader::TraceReader ()
+  : m_data (0),
+    m_size (0),
+    m_offset (0),
+    m_csv (false),
+    m_line (0),
+    m_lastTime (0)
+{
+}
+
+TraceReader::~TraceReader ()
+{
+  if (m_data != 0)
+    {
+      munmap ((void *) m_data, m_size);
+    }
+}
+
+void
+TraceReader::Open (const std::string &fileName)
+{
+  m_fileName = fileName;
+  int fd = open (fileName.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Cannot open trace " << fileName);
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) < 0, "Cannot stat trace " << fileName);
+  m_size = st.st_size;
+  if (m_size > 0)
+    {
+      void *data = mmap (0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      NS_ABORT_MSG_IF (data == MAP_FAILED, "Cannot map trace " << fileName);
+      madvise (data, m_size, MADV_SEQUENTIAL);
+      m_data = (const char *) data;
+    }
+  close (fd);
+
+  m_csv = fileName.size () >= 4 && fileName.compare (fileName.size () - 4, 4, ".csv") == 0;
+  if (!m_csv)
+    {
+      NS_ABORT_MSG_UNLESS (m_size >= sizeof (TRACE_MAGIC) && std::memcmp (m_data, TRACE_MAGIC, sizeof (TRACE_MAGIC)) == 0,
+                           "Trace " << fileName << " is neither .csv nor a binary trace");
+      NS_ABORT_MSG_UNLESS ((m_size - sizeof (TRACE_MAGIC)) % TRACE_RECORD_SIZE == 0,
+                           "Trace " << fileName << " ends in the middle of a record");
+      m_offset = sizeof (TRACE_MAGIC);
+    }
+}
+
+bool
+TraceReader::Next (TraceRecord &record)
+{
+  if (m_csv)
+    {
+      if (!NextCsv (record))
+        {
+          return false;
+        }
+    }
+  else
+    {
+      if (m_offset + TRACE_RECORD_SIZE > m_size)
+        {
+          return false;
+        }
+      record = DecodeTraceRecord ((const unsigned char *) m_data + m_offset);
+      m_offset += TRACE_RECORD_SIZE;
+      m_line++;
+    }
+  NS_ABORT_MSG_IF (record.time < m_lastTime, "Trace " << m_fileName << " is not in time order at record " << m_line);
+  m_lastTime = record.time;
+  return true;
+}
+
+bool
+TraceReader::NextCsv (TraceRecord &record)
+{
+  while (m_offset < m_size)
+    {
+      const char *start = m_data + m_offset;
+      const char *end = (const char *) std::memchr (start, '\n', m_size - m_offset);
+      size_t length = end ? end - start : m_size - m_offset;
+      m_offset += length + 1;
+      m_line++;
+      if (length == 0 || *start < '0' || *start > '9')
+        {
+          continue;
+        }
+      /* The mapping is not NUL terminated, parse a copy of the line. */
+      std::string line (start, length);
+      double time;
+      unsigned int station, size;
+      NS_ABORT_MSG_UNLESS (std::sscanf (line.c_str (), "%lf,%u,%u", &time, &station, &size) == 3,
+                           "Bad trace line " << m_line << " in " << m_fileName << ": " << line);
+      record.time = time * 1e9 + 0.5;
+      record.station = station;
+      record.size = size;
+      return true;
+    }
+  return false;
+}
+
+/* Sends what it is given over a TCP connection, queueing what the socket
+ * buffer cannot take yet. */
+class TraceReplayApplication : public Application
+{
+public:
+  static TypeId GetTypeId (void);
+  TraceReplayApplication ();
+
+  /* Connect to peer when started, or once the node's wifi MAC associated
+   * if waitForAssociation. */
+  void Setup (Address peer, bool waitForAssociation);
+  void Send (uint32_t size);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+  void Connect (void);
+  void Associated (Mac48Address bssid);
+  void Flush (Ptr<Socket> socket, uint32_t available);
+
+  Ptr<Socket> m_socket;
+  Address m_peer;
+  bool m_waitForAssociation;
+  bool m_running;
+  uint64_t m_backlog;                                /* Bytes waiting for socket buffer space. */
+};
+
+NS_OBJECT_ENSURE_REGISTERED (TraceReplayApplication);
+
+TypeId
+TraceReplayApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceReplayApplication")
+    .SetParent<Application> ()
+    .AddConstructor<TraceReplayApplication> ()
+  ;
+  return tid;
+}
+
+TraceReplayApplication::TraceReplayApplication ()
+  : m_waitForAssociation (false),
+    m_running (false),
+    m_backlog (0)
+{
+}
+
+void
+TraceReplayApplication::Setup (Address peer, bool waitForAssociation)
+{
+  m_peer = peer;
+  m_waitForAssociation = waitForAssociation;
+}
+
+void
+TraceReplayApplication::Send (uint32_t size)
+{
+  /* Records due before the application started wait for it. */
+  m_backlog += size;
+  if (m_socket != 0)
+    {
+      Flush (m_socket, m_socket->GetTxAvailable ());
+    }
+}
+
+void
+TraceReplayApplication::StartApplication (void)
+{
+  m_running = true;
+  if (!m_waitForAssociation)
+    {
+      Connect ();
+      return;
+    }
+  /* A SYN sent before the association is dropped and only retried after
+   * the TCP connection timeout. */
+  for (uint32_t i = 0; i < GetNode ()->GetNDevices (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (GetNode ()->GetDevice (i));
+      if (device != 0)
+        {
+          device->GetMac ()->TraceConnectWithoutContext ("Assoc", MakeCallback (&TraceReplayApplication::Associated, this));
+        }
+    }
+}
+
+void
+TraceReplayApplication::Connect (void)
+{
+  m_socket = Socket::CreateSocket (GetNode (), TcpSocketFactory::GetTypeId ());
+  m_socket->Bind ();
+  m_socket->Connect (m_peer);
+  m_socket->SetSendCallback (MakeCallback (&TraceReplayApplication::Flush, this));
+  Flush (m_socket, m_socket->GetTxAvailable ());
+}
+
+void
+TraceReplayApplication::Associated (Mac48Address bssid)
+{
+  /* Later re-associations keep the connection. */
+  if (m_running && m_socket == 0)
+    {
+      Connect ();
+    }
+}
+
+void
+TraceReplayApplication::StopApplication (void)
+{
+  m_running = false;
+  if (m_socket != 0)
+    {
+      m_socket->Close ();
+      m_socket = 0;
+    }
+}
+
+void
+TraceReplayApplication::Flush (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_backlog > 0 && available > 0)
+    {
+      uint32_t size = std::min<uint64_t> (m_backlog, available);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          return;
+        }
+      m_backlog -= sent;
+      available -= sent;
+    }
+}
+
+/* Replays a trace over one TraceReplayApplication per station. */
+class TraceReplay
+{
+public:
+  TraceReplay ();
+
+  /* Install the applications, running from start to stop, and schedule the
+   * first record. */
+  ApplicationContainer Install (const std::string &fileName, NodeContainer stations, Address remote,
+                                Time start, Time stop);
+  /* Install nothing yet: the node of a station is built by activate when
+   * its first record is due, and gets its application then. */
+  void InstallLazy (const std::string &fileName, uint32_t nStations, Callback<Ptr<Node>, uint32_t> activate,
+                    Address remote, Time start, Time stop);
+
+  uint64_t GetRecords (void) const;                  /* Records sent. */
+  uint64_t GetSkipped (void) const;                  /* Records of stations beyond the last one. */
+
+private:
+  void Open (const std::string &fileName, Time start, Time stop);
+  void Activate (uint32_t station);
+  void Dispatch (void);
+
+  TraceReader m_reader;
+  TraceRecord m_next;
+  std::vector<Ptr<TraceReplayApplication> > m_applications;
+  Callback<Ptr<Node>, uint32_t> m_activate;
+  Address m_remote;
+  Time m_start;
+  Time m_stop;
+  uint64_t m_records;
+  uint64_t m_skipped;
+};
+
+TraceReplay::TraceReplay ()
+  : m_records (0),
+    m_skipped (0)
+{
+}
+
+ApplicationContainer
+TraceReplay::Install (const std::string &fileName, NodeContainer stations, Address remote,
+                      Time start, Time stop)
+{
+  ApplicationContainer applications;
+  for (NodeContainer::Iterator i = stations.Begin (); i != stations.End (); ++i)
+    {
+      Ptr<TraceReplayApplication> application = CreateObject<TraceReplayApplication> ();
+      application->Setup (remote, false);
+      (*i)->AddApplication (application);
+      m_applications.push_back (application);
+      applications.Add (application);
+    }
+  applications.Start (start);
+  applications.Stop (stop);
+  Open (fileName, start, stop);
+  return applications;
+}
+
+void
+TraceReplay::InstallLazy (const std::string &fileName, uint32_t nStations, Callback<Ptr<Node>, uint32_t> activate,
+                          Address remote, Time start, Time stop)
+{
+  m_applications.resize (nStations);
+  m_activate = activate;
+  m_remote = remote;
+  Open (fileName, start, stop);
+}
+
+void
+TraceReplay::Open (const std::string &fileName, Time start, Time stop)
+{
+  m_start = start;
+  m_stop = stop;
+  m_reader.Open (fileName);
+  if (m_reader.Next (m_next) && m_start + NanoSeconds (m_next.time) < m_stop)
+    {
+      Simulator::Schedule (m_start + NanoSeconds (m_next.time), &TraceReplay::Dispatch, this);
+    }
+}
+
+void
+TraceReplay::Activate (uint32_t station)
+{
+  Ptr<Node> node = m_activate (station);
+  Ptr<TraceReplayApplication> application = CreateObject<TraceReplayApplication> ();
+  application->Setup (m_remote, true);
+  /* Start and stop times count from when the node initializes it, now. */
+  application->SetStartTime (Seconds (0));
+  application->SetStopTime (m_stop - Simulator::Now ());
+  node->AddApplication (application);
+  m_applications[station] = application;
+}
+
+uint64_t
+TraceReplay::GetRecords (void) const
+{
+  return m_records;
+}
+
+uint64_t
+TraceReplay::GetSkipped (void) const
+{
+  return m_skipped;
+}
+
+void
+TraceReplay::Dispatch (void)
+{
+  /* Everything due now, then wait for the next record. */
+  Time next;
+  do
+    {
+      if (m_next.station < m_applications.size ())
+        {
+          if (m_applications[m_next.station] == 0)
+            {
+              Activate (m_next.station);
+            }
+          m_applications[m_next.station]->Send (m_next.size);
+          m_records++;
+        }
+      else
+        {
+          m_skipped++;
+        }
+      if (!m_reader.Next (m_next))
+        {
+          return;
+        }
+      next = m_start + NanoSeconds (m_next.time);
+    }
+  while (next <= Simulator::Now ());
+  if (next < m_stop)
+    {
+      Simulator::Schedule (next - Simulator::Now (), &TraceReplay::Dispatch, this);
+    }
+}
+
+} // namespace ns3
+
+#endif /* TRACE_REPLAY_H */
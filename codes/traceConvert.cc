@@ -0,0 +1,51 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This converts a CSV packet trace into the binary trace format that
+ * tcp-80211b --trace replays, see trace-replay.h.
+ * Use the following command to run:
+ * ./waf --run "traceConvert --input=traffic.csv --output=traffic.trace"
+ */
+
+#include "ns3/core-module.h"
+#include "trace-replay.h"
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE ("traceConvert");
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input = "";
+  std::string output = "";
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("input", "CSV trace, one time,station,size line per packet", input);
+  cmd.AddValue ("output", "Binary trace to write", output);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (input.size () < 4 || input.compare (input.size () - 4, 4, ".csv") != 0,
+                   "--input must name a .csv trace");
+  NS_ABORT_MSG_IF (output == "", "--output is missing");
+
+  TraceReader reader;
+  reader.Open (input);
+  std::ofstream file (output.c_str (), std::ios::binary);
+  NS_ABORT_MSG_UNLESS (file.is_open (), "Cannot write " << output);
+  file.write (TRACE_MAGIC, sizeof (TRACE_MAGIC));
+  TraceRecord record;
+  unsigned char data[TRACE_RECORD_SIZE];
+  uint64_t records = 0;
+  while (reader.Next (record))
+    {
+      EncodeTraceRecord (record, data);
+      file.write ((const char *) data, sizeof (data));
+      records++;
+    }
+  file.close ();
+  std::cout << records << " records written to " << output << std::endl;
+  return 0;
+}
@@ -0,0 +1,599 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Author: Qiaoqiao Li <joyinbritish@me.com>
+ *
+ * This analyses the .dat files the sweeps write and plots them, without ns-3.
+ * Build and run it with:
+ * g++ -O2 -std=c++11 -o sweepAnalysis tools/sweepAnalysis.cc
+ * ./sweepAnalysis outputs/phyRate.dat
+ * ./sweepAnalysis --x=payloadSize --by=nWifi,file outputs/payloadSize*.dat
+ *
+ * A .dat file is a header line of tab separated column names and one line
+ * per point; lines starting with # are skipped. The files are read one line
+ * at a time and the rows of each point (same group and x) are folded into a
+ * running mean and variance (Welford), so memory follows the number of
+ * points, not rows: repeated runs of a point (--seed, --run) become its
+ * replicates. Columns are found by name, so columns the tool does not use,
+ * such as manifest, are ignored.
+ *
+ * The options are
+ *   --x       the axis, default nWifi,
+ *   --y       the response, default throughput,
+ *   --by      the columns that tell the curves apart, default every column
+ *             left of y other than x, and "file" (the name of the input)
+ *             when there are several inputs,
+ *   --tolerance  saturation is reached within this share of the peak, in [0, 1),
+ *   --svg     the plot to write, default <first input>-<x>.svg, empty disables it.
+ *
+ * For each curve we report
+ * - peak: the x with the largest mean,
+ * - saturation: the smallest x whose mean is within tolerance of the peak,
+ *   beyond it more x gains little or loses,
+ * - knee: the point furthest from the chord between the first and the last
+ *   point, both axes scaled to [0, 1] (Kneedle),
+ * - reversal: the first x whose mean falls below the previous one by more
+ *   than their 95% confidence intervals allow (by more than the tolerance
+ *   without replicates),
+ * and for each x the best curve, and whether Welch's t-test at 95% tells it
+ * apart from the second best.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Running mean and variance of the replicates of one point. */
+struct Welford
+{
+  uint64_t n = 0;
+  double mean = 0;
+  double m2 = 0;
+
+  void Add (double value)
+  {
+    n++;
+    double delta = value - mean;
+    mean += delta / n;
+    m2 += delta * (value - mean);
+  }
+  double GetVariance (void) const
+  {
+    return n > 1 ? m2 / (n - 1) : 0;
+  }
+};
+
+/* Two sided 95% quantile of Student's t distribution. */
+double
+GetStudentT (double df)
+{
+  static const double table[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+  };
+  if (df < 1)
+    {
+      return INFINITY;
+    }
+  if (df <= 30)
+    {
+      return table[(int) df - 1];
+    }
+  return df <= 60 ? 2.021 : (df <= 120 ? 2.000 : 1.960);
+}
+
+/* Half width of the 95% confidence interval of the mean, 0 without replicates. */
+double
+GetConfidence (const Welford &point)
+{
+  if (point.n < 2)
+    {
+      return 0;
+    }
+  return GetStudentT (point.n - 1) * std::sqrt (point.GetVariance () / point.n);
+}
+
+/* 1 if a is above b, -1 if below, 0 if Welch's t-test cannot tell them
+ * apart at 95%, which is always the case without replicates. */
+int
+CompareWelch (const Welford &a, const Welford &b)
+{
+  if (a.n < 2 || b.n < 2)
+    {
+      return 0;
+    }
+  double va = a.GetVariance () / a.n;
+  double vb = b.GetVariance () / b.n;
+  if (va + vb == 0)
+    {
+      return a.mean == b.mean ? 0 : (a.mean > b.mean ? 1 : -1);
+    }
+  double t = (a.mean - b.mean) / std::sqrt (va + vb);
+  double df = (va + vb) * (va + vb) / (va * va / (a.n - 1) + vb * vb / (b.n - 1));
+  if (std::abs (t) <= GetStudentT (df))
+    {
+      return 0;
+    }
+  return t > 0 ? 1 : -1;
+}
+
+std::vector<std::string>
+Split (const std::string &line, char separator)
+{
+  std::vector<std::string> fields;
+  std::string::size_type start = 0;
+  while (true)
+    {
+      std::string::size_type end = line.find (separator, start);
+      fields.push_back (line.substr (start, end - start));
+      if (end == std::string::npos)
+        {
+          return fields;
+        }
+      start = end + 1;
+    }
+}
+
+std::string
+GetStem (const std::string &path)
+{
+  std::string::size_type slash = path.find_last_of ('/');
+  std::string name = slash == std::string::npos ? path : path.substr (slash + 1);
+  std::string::size_type dot = name.find_last_of ('.');
+  return dot == std::string::npos ? name : name.substr (0, dot);
+}
+
+/* A number, with an optional unit such as bps after an optional k, M or G
+ * (dataRate=100Mbps is 1e8). */
+bool
+ParseNumber (const std::string &text, double &value)
+{
+  char *end;
+  value = std::strtod (text.c_str (), &end);
+  if (end == text.c_str ())
+    {
+      return false;
+    }
+  switch (*end)
+    {
+    case 'k':
+    case 'K':
+      value *= 1e3;
+      end++;
+      break;
+    case 'M':
+      value *= 1e6;
+      end++;
+      break;
+    case 'G':
+      value *= 1e9;
+      end++;
+      break;
+    }
+  while (std::isalpha (*end))
+    {
+      end++;
+    }
+  return *end == '\0';
+}
+
+typedef std::map<double, Welford> Curve;
+
+struct CurveFeatures
+{
+  double peakX = 0;
+  double peakY = 0;
+  double saturationX = 0;
+  double kneeX = 0;
+  double kneeY = 0;
+  bool reversal = false;
+  double reversalX = 0;
+};
+
+CurveFeatures
+Analyse (const Curve &curve, double tolerance)
+{
+  CurveFeatures features;
+  std::vector<double> xs;
+  std::vector<Welford> ys;
+  for (Curve::const_iterator i = curve.begin (); i != curve.end (); ++i)
+    {
+      xs.push_back (i->first);
+      ys.push_back (i->second);
+    }
+  uint32_t n = xs.size ();
+
+  uint32_t peak = 0;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      if (ys[i].mean > ys[peak].mean)
+        {
+          peak = i;
+        }
+    }
+  features.peakX = xs[peak];
+  features.peakY = ys[peak].mean;
+
+  /* The first point the rest of the curve no longer improves on much. */
+  uint32_t saturation = 0;
+  while (saturation < peak && ys[saturation].mean < (1 - tolerance) * features.peakY)
+    {
+      saturation++;
+    }
+  features.saturationX = xs[saturation];
+
+  double minY = ys[0].mean;
+  double maxY = ys[0].mean;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      minY = std::min (minY, ys[i].mean);
+      maxY = std::max (maxY, ys[i].mean);
+    }
+  uint32_t knee = 0;
+  double kneeDistance = -1;
+  for (uint32_t i = 0; i < n && n > 2 && maxY > minY; i++)
+    {
+      double x = (xs[i] - xs[0]) / (xs[n - 1] - xs[0]);
+      double y = (ys[i].mean - minY) / (maxY - minY);
+      double chord = (ys[0].mean - minY) / (maxY - minY)
+        + x * (ys[n - 1].mean - ys[0].mean) / (maxY - minY);
+      double distance = std::abs (y - chord);
+      if (distance > kneeDistance)
+        {
+          kneeDistance = distance;
+          knee = i;
+        }
+    }
+  features.kneeX = xs[knee];
+  features.kneeY = ys[knee].mean;
+
+  for (uint32_t i = 1; i < n && !features.reversal; i++)
+    {
+      bool replicated = ys[i].n > 1 && ys[i - 1].n > 1;
+      if (replicated ? CompareWelch (ys[i], ys[i - 1]) < 0
+                     : ys[i].mean < (1 - tolerance) * ys[i - 1].mean)
+        {
+          features.reversal = true;
+          features.reversalX = xs[i];
+        }
+    }
+  return features;
+}
+
+/* One polyline per curve, with its confidence intervals and knee. */
+void
+WritePlot (const std::string &fileName, const std::map<std::string, Curve> &curves,
+           const std::map<std::string, CurveFeatures> &features, const std::string &xName, const std::string &yName)
+{
+  static const char *colors[] = { "#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd",
+                                  "#8c564b", "#e377c2", "#7f7f7f", "#bcbd22", "#17becf" };
+  const double width = 800, height = 500, left = 70, right = 220, top = 20, bottom = 50;
+  double minX = INFINITY, maxX = -INFINITY, minY = 0, maxY = -INFINITY;
+  for (std::map<std::string, Curve>::const_iterator c = curves.begin (); c != curves.end (); ++c)
+    {
+      for (Curve::const_iterator p = c->second.begin (); p != c->second.end (); ++p)
+        {
+          minX = std::min (minX, p->first);
+          maxX = std::max (maxX, p->first);
+          minY = std::min (minY, p->second.mean - GetConfidence (p->second));
+          maxY = std::max (maxY, p->second.mean + GetConfidence (p->second));
+        }
+    }
+  if (maxX == minX)
+    {
+      maxX = minX + 1;
+    }
+  if (maxY <= minY)
+    {
+      maxY = minY + 1;
+    }
+  double plotWidth = width - left - right;
+  double plotHeight = height - top - bottom;
+#define PLOT_X(x) (left + ((x) - minX) / (maxX - minX) * plotWidth)
+#define PLOT_Y(y) (top + plotHeight - ((y) - minY) / (maxY - minY) * plotHeight)
+
+  std::ofstream svg (fileName.c_str ());
+  svg.precision (5);
+  svg << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height
+      << "\" font-family=\"sans-serif\" font-size=\"12\">" << std::endl;
+  svg << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>" << std::endl;
+  svg << "<rect x=\"" << left << "\" y=\"" << top << "\" width=\"" << plotWidth << "\" height=\"" << plotHeight
+      << "\" fill=\"none\" stroke=\"black\"/>" << std::endl;
+  for (uint32_t tick = 0; tick <= 5; tick++)
+    {
+      double x = minX + (maxX - minX) * tick / 5;
+      double y = minY + (maxY - minY) * tick / 5;
+      svg << "<text x=\"" << PLOT_X (x) << "\" y=\"" << top + plotHeight + 18 << "\" text-anchor=\"middle\">" << x << "</text>" << std::endl;
+      svg << "<text x=\"" << left - 6 << "\" y=\"" << PLOT_Y (y) + 4 << "\" text-anchor=\"end\">" << y << "</text>" << std::endl;
+    }
+  svg << "<text x=\"" << left + plotWidth / 2 << "\" y=\"" << height - 10 << "\" text-anchor=\"middle\">" << xName << "</text>" << std::endl;
+  svg << "<text x=\"15\" y=\"" << top + plotHeight / 2 << "\" text-anchor=\"middle\" transform=\"rotate(-90 15 "
+      << top + plotHeight / 2 << ")\">" << yName << "</text>" << std::endl;
+
+  uint32_t index = 0;
+  for (std::map<std::string, Curve>::const_iterator c = curves.begin (); c != curves.end (); ++c, ++index)
+    {
+      const char *color = colors[index % 10];
+      svg << "<polyline fill=\"none\" stroke=\"" << color << "\" points=\"";
+      for (Curve::const_iterator p = c->second.begin (); p != c->second.end (); ++p)
+        {
+          svg << PLOT_X (p->first) << "," << PLOT_Y (p->second.mean) << " ";
+        }
+      svg << "\"/>" << std::endl;
+      for (Curve::const_iterator p = c->second.begin (); p != c->second.end (); ++p)
+        {
+          double confidence = GetConfidence (p->second);
+          if (confidence > 0)
+            {
+              svg << "<line x1=\"" << PLOT_X (p->first) << "\" x2=\"" << PLOT_X (p->first)
+                  << "\" y1=\"" << PLOT_Y (p->second.mean - confidence) << "\" y2=\"" << PLOT_Y (p->second.mean + confidence)
+                  << "\" stroke=\"" << color << "\"/>" << std::endl;
+            }
+        }
+      const CurveFeatures &f = features.find (c->first)->second;
+      svg << "<circle cx=\"" << PLOT_X (f.kneeX) << "\" cy=\"" << PLOT_Y (f.kneeY) << "\" r=\"4\" fill=\"none\" stroke=\""
+          << color << "\"><title>knee " << c->first << " " << xName << "=" << f.kneeX << "</title></circle>" << std::endl;
+      if (index < 20)
+        {
+          double y = top + 10 + 16 * index;
+          svg << "<line x1=\"" << width - right + 10 << "\" x2=\"" << width - right + 30 << "\" y1=\"" << y - 4
+              << "\" y2=\"" << y - 4 << "\" stroke=\"" << color << "\"/>" << std::endl;
+          svg << "<text x=\"" << width - right + 36 << "\" y=\"" << y << "\">" << (c->first == "" ? yName : c->first)
+              << "</text>" << std::endl;
+        }
+    }
+  svg << "</svg>" << std::endl;
+#undef PLOT_X
+#undef PLOT_Y
+}
+
+int main (int argc, char *argv[])
+{
+  std::string xName = "nWifi";
+  std::string yName = "throughput";
+  std::string by = "";
+  bool byGiven = false;
+  double tolerance = 0.05;
+  std::string svgName = "";
+  bool svgGiven = false;
+  std::vector<std::string> inputs;
+
+  /* Command line argument parser setup. */
+  for (int i = 1; i < argc; i++)
+    {
+      std::string argument = argv[i];
+      std::string::size_type equals = argument.find ('=');
+      std::string name = argument.substr (0, equals);
+      std::string value = equals == std::string::npos ? "" : argument.substr (equals + 1);
+      if (name == "--x")
+        {
+          xName = value;
+        }
+      else if (name == "--y")
+        {
+          yName = value;
+        }
+      else if (name == "--by")
+        {
+          by = value;
+          byGiven = true;
+        }
+      else if (name == "--tolerance")
+        {
+          char *end = 0;
+          tolerance = std::strtod (value.c_str (), &end);
+          if (value.empty () || *end != '\0' || !(tolerance >= 0 && tolerance < 1))
+            {
+              std::cerr << "--tolerance must be a number in [0, 1), got " << value << std::endl;
+              return 1;
+            }
+        }
+      else if (name == "--svg")
+        {
+          svgName = value;
+          svgGiven = true;
+        }
+      else if (argument.compare (0, 2, "--") == 0)
+        {
+          std::cerr << "Unknown option " << argument << ", use --x, --y, --by, --tolerance or --svg" << std::endl;
+          return 1;
+        }
+      else
+        {
+          inputs.push_back (argument);
+        }
+    }
+  if (inputs.empty ())
+    {
+      std::cerr << "Usage: sweepAnalysis [--x=nWifi] [--y=throughput] [--by=a,b] [--tolerance=0.05] [--svg=plot.svg] file.dat..." << std::endl;
+      return 1;
+    }
+  if (!svgGiven)
+    {
+      svgName = GetStem (inputs[0]) + "-" + xName + ".svg";
+    }
+
+  /* Stream every input into its curves. */
+  std::map<std::string, Curve> curves;
+  uint64_t rows = 0;
+  uint64_t skipped = 0;
+  for (std::vector<std::string>::const_iterator input = inputs.begin (); input != inputs.end (); ++input)
+    {
+      std::ifstream file (input->c_str ());
+      if (!file.is_open ())
+        {
+          std::cerr << "Cannot read " << *input << std::endl;
+          return 1;
+        }
+      std::string line;
+      std::vector<std::string> header;
+      while (header.empty () && std::getline (file, line))
+        {
+          if (!line.empty () && line[line.size () - 1] == '\r')
+            {
+              line.erase (line.size () - 1);
+            }
+          if (!line.empty () && line[0] != '#')
+            {
+              header = Split (line, '\t');
+            }
+        }
+      int x = -1;
+      int y = -1;
+      for (uint32_t i = 0; i < header.size (); i++)
+        {
+          x = header[i] == xName ? i : x;
+          y = header[i] == yName ? i : y;
+        }
+      if (x < 0 || y < 0)
+        {
+          std::cerr << *input << " has no " << (x < 0 ? xName : yName) << " column" << std::endl;
+          return 1;
+        }
+      std::vector<std::string> groupColumns;
+      if (byGiven)
+        {
+          groupColumns = by == "" ? std::vector<std::string> () : Split (by, ',');
+        }
+      else
+        {
+          for (int i = 0; i < y; i++)
+            {
+              if (i != x)
+                {
+                  groupColumns.push_back (header[i]);
+                }
+            }
+          if (inputs.size () > 1)
+            {
+              groupColumns.push_back ("file");
+            }
+        }
+      std::vector<int> groupIndices;
+      for (std::vector<std::string>::const_iterator c = groupColumns.begin (); c != groupColumns.end (); ++c)
+        {
+          int index = *c == "file" ? -2 : -1;
+          for (uint32_t i = 0; i < header.size (); i++)
+            {
+              index = header[i] == *c ? i : index;
+            }
+          if (index == -1)
+            {
+              std::cerr << *input << " has no " << *c << " column" << std::endl;
+              return 1;
+            }
+          groupIndices.push_back (index);
+        }
+
+      std::string stem = GetStem (*input);
+      while (std::getline (file, line))
+        {
+          if (!line.empty () && line[line.size () - 1] == '\r')
+            {
+              line.erase (line.size () - 1);
+            }
+          if (line.empty () || line[0] == '#')
+            {
+              continue;
+            }
+          std::vector<std::string> fields = Split (line, '\t');
+          double xValue, yValue;
+          if (fields.size () != header.size () || !ParseNumber (fields[x], xValue) || !ParseNumber (fields[y], yValue))
+            {
+              skipped++;
+              continue;
+            }
+          std::ostringstream group;
+          for (uint32_t i = 0; i < groupIndices.size (); i++)
+            {
+              group << (i > 0 ? " " : "") << groupColumns[i] << "="
+                    << (groupIndices[i] == -2 ? stem : fields[groupIndices[i]]);
+            }
+          curves[group.str ()][xValue].Add (yValue);
+          rows++;
+        }
+    }
+  if (curves.empty ())
+    {
+      std::cerr << "No rows with a numeric " << xName << " and " << yName << std::endl;
+      return 1;
+    }
+
+  std::cout << "# " << rows << " rows, " << curves.size () << " curves";
+  if (skipped > 0)
+    {
+      std::cout << ", " << skipped << " malformed rows skipped";
+    }
+  std::cout << std::endl;
+  std::cout << "curve" << "\t" << "points" << "\t" << "peak" << xName << "\t" << "peak" << "\t" << "saturation" << xName
+            << "\t" << "knee" << xName << "\t" << "knee" << "\t" << "reversal" << xName << std::endl;
+  std::map<std::string, CurveFeatures> features;
+  for (std::map<std::string, Curve>::const_iterator c = curves.begin (); c != curves.end (); ++c)
+    {
+      CurveFeatures f = Analyse (c->second, tolerance);
+      features[c->first] = f;
+      std::cout << (c->first == "" ? "all" : c->first) << "\t" << c->second.size () << "\t" << f.peakX << "\t" << f.peakY
+                << "\t" << f.saturationX << "\t" << f.kneeX << "\t" << f.kneeY << "\t";
+      if (f.reversal)
+        {
+          std::cout << f.reversalX;
+        }
+      else
+        {
+          std::cout << "-";
+        }
+      std::cout << std::endl;
+    }
+
+  /* The best curve at every x. */
+  if (curves.size () > 1)
+    {
+      std::map<double, std::vector<std::pair<std::string, Welford> > > byX;
+      for (std::map<std::string, Curve>::const_iterator c = curves.begin (); c != curves.end (); ++c)
+        {
+          for (Curve::const_iterator p = c->second.begin (); p != c->second.end (); ++p)
+            {
+              byX[p->first].push_back (std::make_pair (c->first, p->second));
+            }
+        }
+      for (std::map<double, std::vector<std::pair<std::string, Welford> > >::iterator i = byX.begin (); i != byX.end (); ++i)
+        {
+          std::vector<std::pair<std::string, Welford> > &points = i->second;
+          std::sort (points.begin (), points.end (),
+                     [] (const std::pair<std::string, Welford> &a, const std::pair<std::string, Welford> &b)
+                     { return a.second.mean > b.second.mean; });
+          std::cout << "# " << xName << "=" << i->first << ": best " << points[0].first << " " << yName << " "
+                    << points[0].second.mean;
+          if (points[0].second.n > 1)
+            {
+              std::cout << " +- " << GetConfidence (points[0].second);
+            }
+          if (points.size () > 1 && (points[0].second.n < 2 || points[1].second.n < 2))
+            {
+              std::cout << ", ahead of " << points[1].first << " " << points[1].second.mean << " (no replicates)";
+            }
+          else if (points.size () > 1)
+            {
+              std::cout << (CompareWelch (points[0].second, points[1].second) > 0 ? ", significantly above "
+                                                                                  : ", not distinguishable from ")
+                        << points[1].first << " " << points[1].second.mean;
+            }
+          std::cout << std::endl;
+        }
+    }
+
+  if (svgName != "")
+    {
+      WritePlot (svgName, curves, features, xName, yName);
+      std::cout << "# plot written to " << svgName << std::endl;
+    }
+  return 0;
+}